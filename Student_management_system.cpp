@@ -19,6 +19,41 @@
 #include <stdexcept>
 #include <iomanip>
 #include <limits>
+#include <array>
+#include <bitset>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+#include <charconv>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <cstddef>
+
+// POSIX file APIs (pwrite, sockets, mmap) are used where available
+#if defined(__unix__) || defined(__APPLE__)
+#define SMS_HAVE_POSIX 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <csignal>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#else
+#define SMS_HAVE_POSIX 0
+#endif
 
 // Avoiding 'using namespace std;' for better practice
 using std::cout;
@@ -178,6 +213,77 @@ void bubbleSort(vector<T*>& arr, bool (*compare)(T*, T*)) {
     }
 }
 
+// ==================== GRADING POLICIES (COMPILE-TIME TEMPLATES) ====================
+// Each grading policy is a plain type: a list of grade labels and the minimum
+// score needed for each one, best grade first. GradeTable<Policy> turns the
+// cut-offs into a 101-entry lookup array at compile time, so grading a student
+// is one indexed load instead of an if/else chain.
+enum class GradingScheme { Absolute, Cgpa, PassFail, Relative };
+
+// Fixed thresholds on the average (the original A+ to F scheme)
+struct AbsoluteGrading {
+    static constexpr const char* name = "Absolute (A+ to F)";
+    static constexpr int numGrades = 6;
+    static constexpr const char* labels[numGrades] = {"A+", "A", "B", "C", "D", "F"};
+    static constexpr int cutoffs[numGrades] = {90, 80, 70, 60, 50, 0};
+};
+
+// 10-point CGPA scale, grade point shown next to the letter
+struct CgpaGrading {
+    static constexpr const char* name = "CGPA (10-point scale)";
+    static constexpr int numGrades = 8;
+    static constexpr const char* labels[numGrades] = {
+        "O (10)", "A+ (9)", "A (8)", "B+ (7)", "B (6)", "C (5)", "P (4)", "F (0)"};
+    static constexpr int cutoffs[numGrades] = {90, 80, 70, 60, 50, 45, 40, 0};
+};
+
+// Pass/Fail only, pass mark matches the lowest passing absolute grade
+struct PassFailGrading {
+    static constexpr const char* name = "Pass/Fail";
+    static constexpr int numGrades = 2;
+    static constexpr const char* labels[numGrades] = {"Pass", "Fail"};
+    static constexpr int cutoffs[numGrades] = {50, 0};
+};
+
+// Relative (curve) grading: cut-offs are percentile ranks within the cohort,
+// e.g. the top 10% get A+ whatever their actual marks are
+struct RelativeGrading {
+    static constexpr const char* name = "Relative (curve)";
+    static constexpr int numGrades = 6;
+    static constexpr const char* labels[numGrades] = {"A+", "A", "B", "C", "D", "F"};
+    static constexpr int cutoffs[numGrades] = {90, 75, 50, 25, 10, 0};
+};
+
+// Template class holding the compile-time lookup table for a policy
+template <typename Policy>
+struct GradeTable {
+    static constexpr std::array<unsigned char, 101> build() {
+        std::array<unsigned char, 101> table{};
+        for (int score = 0; score <= 100; score++) {
+            int code = Policy::numGrades - 1;
+            for (int g = 0; g < Policy::numGrades; g++) {
+                if (score >= Policy::cutoffs[g]) {
+                    code = g;
+                    break;
+                }
+            }
+            table[score] = static_cast<unsigned char>(code);
+        }
+        return table;
+    }
+    
+    static constexpr std::array<unsigned char, 101> codes = build();
+    
+    // Scores are truncated (not rounded up) so that 89.9 stays below the 90 cut-off
+    static int index(double score) {
+        int i = static_cast<int>(score);
+        return i < 0 ? 0 : (i > 100 ? 100 : i);
+    }
+    
+    static unsigned char code(double score) { return codes[index(score)]; }
+    static const char* label(double score) { return Policy::labels[code(score)]; }
+};
+
 // ==================== ABSTRACT BASE CLASS (POLYMORPHISM) ====================
 // Abstract base class for Users
 class User {
@@ -244,22 +350,153 @@ public:
     string getSubject() const { return subject; }
 };
 
+// ==================== STRING INTERNING (SHARED STRING POOL) ====================
+// A cohort has only a few dozen distinct course names, so each course string
+// is stored once and students keep a 16-bit course id. Names are copied into
+// large arena chunks and students keep a string_view into them, so there is no
+// per-name heap allocation and accessors never copy.
+// The pool is only written from the menu thread; worker threads only read views.
+class StringPool {
+private:
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+    
+    vector<std::unique_ptr<char[]>> chunks;
+    vector<std::unique_ptr<char[]>> largeBlocks;
+    size_t chunkUsed;
+    size_t arenaBytes;   // bytes handed out for names
+    size_t largeBytes;
+    std::deque<string> courseNames;  // deque keeps the strings at fixed addresses
+    std::unordered_map<std::string_view, unsigned short> courseIds;
+    
+public:
+    StringPool() : chunkUsed(CHUNK_SIZE), arenaBytes(0), largeBytes(0) {
+        internCourse("");  // id 0 is the empty course
+    }
+    
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+    
+    static StringPool& global() {
+        static StringPool pool;
+        return pool;
+    }
+    
+    unsigned short internCourse(std::string_view courseName) {
+        auto it = courseIds.find(courseName);
+        if (it != courseIds.end()) return it->second;
+        if (courseNames.size() > 0xFFFF) {
+            throw runtime_error("Too many distinct courses");
+        }
+        courseNames.emplace_back(courseName);
+        unsigned short id = static_cast<unsigned short>(courseNames.size() - 1);
+        courseIds.emplace(courseNames.back(), id);
+        return id;
+    }
+    
+    std::string_view course(unsigned short id) const { return courseNames[id]; }
+    size_t numCourses() const { return courseNames.size(); }
+    
+    // Copies text into the arena. Space of replaced names is not reclaimed.
+    std::string_view storeName(std::string_view text) {
+        if (text.empty()) return std::string_view();
+        if (text.size() > CHUNK_SIZE / 4) {
+            // Very long names get a block of their own
+            largeBlocks.emplace_back(new char[text.size()]);
+            std::copy(text.begin(), text.end(), largeBlocks.back().get());
+            arenaBytes += text.size();
+            largeBytes += text.size();
+            return std::string_view(largeBlocks.back().get(), text.size());
+        }
+        if (chunkUsed + text.size() > CHUNK_SIZE) {
+            chunks.emplace_back(new char[CHUNK_SIZE]);
+            chunkUsed = 0;
+        }
+        char* dest = chunks.back().get() + chunkUsed;
+        std::copy(text.begin(), text.end(), dest);
+        chunkUsed += text.size();
+        arenaBytes += text.size();
+        return std::string_view(dest, text.size());
+    }
+    
+    // Copies a whole block of names (e.g. a snapshot's name section) into a
+    // block of its own, which can be handed back with releaseBlock
+    std::string_view storeBlock(std::string_view text) {
+        if (text.empty()) return std::string_view();
+        largeBlocks.emplace_back(new char[text.size()]);
+        std::copy(text.begin(), text.end(), largeBlocks.back().get());
+        arenaBytes += text.size();
+        largeBytes += text.size();
+        return std::string_view(largeBlocks.back().get(), text.size());
+    }
+    
+    // Frees a block from storeBlock. No student may still refer to it.
+    void releaseBlock(std::string_view block) {
+        for (size_t i = 0; i < largeBlocks.size(); i++) {
+            if (largeBlocks[i].get() == block.data()) {
+                arenaBytes -= block.size();
+                largeBytes -= block.size();
+                largeBlocks[i] = std::move(largeBlocks.back());
+                largeBlocks.pop_back();
+                return;
+            }
+        }
+    }
+    
+    // Memory held by the pool (arena chunks, course strings and lookup table)
+    size_t bytesReserved() const {
+        size_t bytes = (chunks.size() + largeBlocks.size()) * sizeof(std::unique_ptr<char[]>);
+        bytes += chunks.size() * CHUNK_SIZE + largeBytes;
+        for (auto& c : courseNames) bytes += sizeof(string) + c.capacity();
+        bytes += courseIds.size() * (sizeof(std::string_view) + sizeof(unsigned short) + 2 * sizeof(void*));
+        return bytes;
+    }
+    
+    size_t nameBytes() const { return arenaBytes; }
+};
+
 // ==================== STUDENT CLASS WITH OPERATOR OVERLOADING ====================
+// Tag for short-lived copies (shard query results, archive lookups): the
+// student keeps its own copy of the name, so the pool's arena does not grow
+struct OwnedName {};
+
 class Student {
 private:
-    int rollNo;
-    string name;
-    string course;
+    std::string_view name;   // points into StringPool::global(), or owned (see ownsName)
     int* marks;  // Dynamic array for marks
+    int rollNo;
     int numSubjects;
+    unsigned short courseId; // interned course name
+    bool ownsName;           // name was allocated with new[] by this student
+    
+    void releaseName() {
+        if (ownsName) {
+            delete[] name.data();
+            ownsName = false;
+        }
+        name = std::string_view();
+    }
+    
+    // Shares a pooled name, deep-copies an owned one
+    void copyName(const Student& other) {
+        if (other.ownsName && !other.name.empty()) {
+            char* copy = new char[other.name.size()];
+            std::copy(other.name.begin(), other.name.end(), copy);
+            name = std::string_view(copy, other.name.size());
+            ownsName = true;
+        } else {
+            name = other.name;
+            ownsName = false;
+        }
+    }
     
 public:
     // Default Constructor
-    Student() : rollNo(0), name(""), course(""), marks(nullptr), numSubjects(0) {}
+    Student() : name(), marks(nullptr), rollNo(0), numSubjects(0), courseId(0), ownsName(false) {}
     
     // Parameterized Constructor
-    Student(int roll, const string& n, const string& c, int subjects = 5) 
-        : rollNo(roll), name(n), course(c), numSubjects(subjects) {
+    Student(int roll, std::string_view n, std::string_view c, int subjects = 5) 
+        : name(StringPool::global().storeName(n)), rollNo(roll), numSubjects(subjects),
+          courseId(StringPool::global().internCourse(c)), ownsName(false) {
         // Dynamic memory allocation
         marks = new int[numSubjects];
         for (int i = 0; i < numSubjects; i++) {
@@ -267,10 +504,38 @@ public:
         }
     }
     
-    // Copy Constructor
+    // Constructor for a short-lived copy that owns its name
+    Student(int roll, std::string_view n, std::string_view c, int subjects, OwnedName)
+        : name(), rollNo(roll), numSubjects(subjects),
+          courseId(StringPool::global().internCourse(c)), ownsName(false) {
+        marks = new int[numSubjects];
+        for (int i = 0; i < numSubjects; i++) {
+            marks[i] = 0;
+        }
+        if (!n.empty()) {
+            char* copy = new char[n.size()];
+            std::copy(n.begin(), n.end(), copy);
+            name = std::string_view(copy, n.size());
+            ownsName = true;
+        }
+    }
+    
+    // Constructor for bulk loading: the name must already be stored in the
+    // pool and the course already interned, so no pool access is needed and
+    // students can be created on several threads at once
+    Student(int roll, std::string_view storedName, unsigned short course, int subjects)
+        : name(storedName), rollNo(roll), numSubjects(subjects), courseId(course), ownsName(false) {
+        marks = new int[numSubjects];
+        for (int i = 0; i < numSubjects; i++) {
+            marks[i] = 0;
+        }
+    }
+    
+    // Copy Constructor (a pooled name and the course stay shared in the pool)
     Student(const Student& other) 
-        : rollNo(other.rollNo), name(other.name), course(other.course), 
-          numSubjects(other.numSubjects) {
+        : name(), rollNo(other.rollNo), numSubjects(other.numSubjects),
+          courseId(other.courseId), ownsName(false) {
+        copyName(other);
         if (other.marks != nullptr && numSubjects > 0) {
             marks = new int[numSubjects];
             for (int i = 0; i < numSubjects; i++) {
@@ -288,6 +553,7 @@ public:
             delete[] marks;
             marks = nullptr;
         }
+        releaseName();
     }
     
     // Assignment operator overloading
@@ -301,8 +567,9 @@ public:
             
             // Copy data
             rollNo = other.rollNo;
-            name = other.name;
-            course = other.course;
+            releaseName();
+            copyName(other);
+            courseId = other.courseId;
             numSubjects = other.numSubjects;
             
             if (other.marks != nullptr && numSubjects > 0) {
@@ -331,15 +598,19 @@ public:
     // Stream insertion operator overloading
     friend ostream& operator<<(ostream& os, const Student& s) {
         os << "Roll No: " << s.rollNo << ", Name: " << s.name 
-           << ", Course: " << s.course << ", Average: " 
+           << ", Course: " << s.getCourse() << ", Average: " 
            << fixed << setprecision(2) << s.getAverage();
         return os;
     }
     
     // Setters
     void setRollNo(int roll) { rollNo = roll; }
-    void setName(const string& n) { name = n; }
-    void setCourse(const string& c) { course = c; }
+    void setName(std::string_view n) {
+        std::string_view stored = StringPool::global().storeName(n);
+        releaseName();
+        name = stored;
+    }
+    void setCourse(std::string_view c) { courseId = StringPool::global().internCourse(c); }
     
     void setMarks(int subject, int mark) {
         if (subject < 0 || subject >= numSubjects) {
@@ -353,8 +624,9 @@ public:
     
     // Getters
     int getRollNo() const { return rollNo; }
-    string getName() const { return name; }
-    string getCourse() const { return course; }
+    std::string_view getName() const { return name; }
+    std::string_view getCourse() const { return StringPool::global().course(courseId); }
+    unsigned short getCourseId() const { return courseId; }
     int getMarks(int subject) const {
         if (marks == nullptr || subject < 0 || subject >= numSubjects) {
             return 0;
@@ -372,200 +644,3345 @@ public:
         return static_cast<double>(total) / numSubjects;
     }
     
-    void displayInfo() const {
-        cout << "\n╔════════════════════════════════════════════╗" << endl;
-        cout << "║          STUDENT INFORMATION               ║" << endl;
-        cout << "╚════════════════════════════════════════════╝" << endl;
-        cout << "Roll Number: " << rollNo << endl;
-        cout << "Name: " << name << endl;
-        cout << "Course: " << course << endl;
-        cout << "Marks:" << endl;
+    // Write the student card (marksheet) to any stream; no flushing per line
+    // so the same code can fill a large buffer when rendering in bulk.
+    // grade is the label under the active grading scheme (see gradeLabel);
+    // without one the absolute grade is shown.
+    void renderMarksheet(ostream& os, const char* grade = nullptr) const {
+        os << "\n╔════════════════════════════════════════════╗\n";
+        os << "║          STUDENT INFORMATION               ║\n";
+        os << "╚════════════════════════════════════════════╝\n";
+        os << "Roll Number: " << rollNo << '\n';
+        os << "Name: " << name << '\n';
+        os << "Course: " << getCourse() << '\n';
+        os << "Marks:\n";
         if (marks != nullptr) {
             for (int i = 0; i < numSubjects; i++) {
-                cout << "  Subject " << (i + 1) << ": " << marks[i] << endl;
+                os << "  Subject " << (i + 1) << ": " << marks[i] << '\n';
             }
         } else {
-            cout << "  No marks recorded" << endl;
+            os << "  No marks recorded\n";
         }
-        cout << "Average: " << fixed << setprecision(2) << getAverage() << endl;
-        cout << "Grade: " << getGrade() << endl;
+        os << "Average: " << fixed << setprecision(2) << getAverage() << '\n';
+        os << "Grade: " << (grade != nullptr ? grade : GradeTable<AbsoluteGrading>::label(getAverage())) << '\n';
+    }
+    
+    void displayInfo(const char* grade = nullptr) const {
+        renderMarksheet(cout, grade);
+        cout.flush();
     }
     
+    // Grade under the fixed absolute scheme, whatever scheme is active
     string getGrade() const {
-        double avg = getAverage();
-        if (avg >= 90) return "A+";
-        else if (avg >= 80) return "A";
-        else if (avg >= 70) return "B";
-        else if (avg >= 60) return "C";
-        else if (avg >= 50) return "D";
-        else return "F";
+        return GradeTable<AbsoluteGrading>::label(getAverage());
     }
 };
 
-// ==================== EXAM CLASS ====================
-class Exam {
-private:
-    string examName;
-    string examDate;
-    int totalMarks;
+// ==================== COHORT GRADING (TEMPLATE SPECIALIZATION) ====================
+// Grades a whole cohort with one policy. The policy is a template parameter, so
+// the loop compiles to a table lookup per student with no virtual dispatch.
+template <typename Policy>
+void gradeCohort(const vector<Student*>& cohort, vector<unsigned char>& codes) {
+    codes.resize(cohort.size());
+    for (size_t i = 0; i < cohort.size(); i++) {
+        codes[i] = GradeTable<Policy>::code(cohort[i]->getAverage());
+    }
+}
+
+// Relative grading needs each student's percentile rank. Instead of sorting,
+// one pass builds a histogram of the 101 possible scores; a prefix sum over the
+// histogram then gives the rank of every score bucket.
+template <>
+void gradeCohort<RelativeGrading>(const vector<Student*>& cohort, vector<unsigned char>& codes) {
+    codes.resize(cohort.size());
+    if (cohort.empty()) return;
     
-public:
-    Exam(const string& name, const string& date, int marks) 
-        : examName(name), examDate(date), totalMarks(marks) {}
+    std::array<size_t, 101> histogram{};
+    vector<unsigned char> buckets(cohort.size());
+    for (size_t i = 0; i < cohort.size(); i++) {
+        buckets[i] = static_cast<unsigned char>(GradeTable<RelativeGrading>::index(cohort[i]->getAverage()));
+        histogram[buckets[i]]++;
+    }
     
-    void displayExamInfo() const {
-        cout << "\n╔════════════════════════════════╗" << endl;
-        cout << "║        EXAM DETAILS            ║" << endl;
-        cout << "╚════════════════════════════════╝" << endl;
-        cout << "Exam Name: " << examName << endl;
-        cout << "Date: " << examDate << endl;
-        cout << "Total Marks: " << totalMarks << endl;
+    // Percentile rank = students below + half of the ties, as a percentage
+    std::array<unsigned char, 101> bucketCode{};
+    size_t below = 0;
+    for (int score = 0; score <= 100; score++) {
+        double percentile = 100.0 * (below + histogram[score] / 2.0) / cohort.size();
+        bucketCode[score] = GradeTable<RelativeGrading>::code(percentile);
+        below += histogram[score];
     }
     
-    string getExamName() const { return examName; }
+    for (size_t i = 0; i < cohort.size(); i++) {
+        codes[i] = bucketCode[buckets[i]];
+    }
+}
+
+// Grade labels for a whole cohort under the scheme chosen at run time, in
+// cohort order. Transcripts and the CSV export use these so they show the
+// same grades as the listings.
+template <typename Policy>
+void cohortLabels(const vector<Student*>& cohort, vector<const char*>& labels) {
+    vector<unsigned char> codes;
+    gradeCohort<Policy>(cohort, codes);
+    labels.resize(cohort.size());
+    for (size_t i = 0; i < cohort.size(); i++) {
+        labels[i] = Policy::labels[codes[i]];
+    }
+}
+
+vector<const char*> gradeLabels(const vector<Student*>& cohort, GradingScheme scheme) {
+    vector<const char*> labels;
+    switch (scheme) {
+        case GradingScheme::Cgpa: cohortLabels<CgpaGrading>(cohort, labels); break;
+        case GradingScheme::PassFail: cohortLabels<PassFailGrading>(cohort, labels); break;
+        case GradingScheme::Relative: cohortLabels<RelativeGrading>(cohort, labels); break;
+        default: cohortLabels<AbsoluteGrading>(cohort, labels);
+    }
+    return labels;
+}
+
+// Grade label for one student (marksheet screens). A relative grade ranks the
+// student within the cohort exactly as gradeCohort does; a student who is not
+// in the cohort (e.g. found in the archive) is ranked as if added to it.
+const char* gradeLabel(const Student& student, const vector<Student*>& cohort, GradingScheme scheme) {
+    double average = student.getAverage();
+    switch (scheme) {
+        case GradingScheme::Cgpa: return GradeTable<CgpaGrading>::label(average);
+        case GradingScheme::PassFail: return GradeTable<PassFailGrading>::label(average);
+        case GradingScheme::Relative: break;
+        default: return GradeTable<AbsoluteGrading>::label(average);
+    }
+    int bucket = GradeTable<RelativeGrading>::index(average);
+    size_t below = 0, tied = 0;
+    bool member = false;
+    for (auto other : cohort) {
+        if (other == &student) member = true;
+        int b = GradeTable<RelativeGrading>::index(other->getAverage());
+        if (b < bucket) below++;
+        else if (b == bucket) tied++;
+    }
+    size_t size = cohort.size();
+    if (!member) {
+        tied++;
+        size++;
+    }
+    return GradeTable<RelativeGrading>::label(100.0 * (below + tied / 2.0) / size);
+}
+
+// Summary statistics that can be merged (across shards, pages, ...)
+struct CohortStats {
+    size_t count = 0;
+    double sumAverage = 0.0;
+    double minAverage = 0.0;
+    double maxAverage = 0.0;
+    
+    double mean() const { return count == 0 ? 0.0 : sumAverage / count; }
+    
+    void merge(const CohortStats& other) {
+        if (other.count == 0) return;
+        minAverage = count == 0 ? other.minAverage : std::min(minAverage, other.minAverage);
+        maxAverage = count == 0 ? other.maxAverage : std::max(maxAverage, other.maxAverage);
+        count += other.count;
+        sumAverage += other.sumAverage;
+    }
 };
 
-// ==================== MANAGEMENT SYSTEM CLASS ====================
-class ManagementSystem {
+// ==================== BULK TRANSCRIPT GENERATION (MULTITHREADING) ====================
+enum class TranscriptFormat { Text, Html };
+
+// Streams marksheets for a whole cohort into one file per course.
+// Worker threads render fixed-size chunks of students into string buffers while
+// the calling thread writes finished chunks to disk strictly in order. Only a
+// small window of chunks can be in flight at once, so memory use stays bounded
+// no matter how many students there are.
+class TranscriptGenerator {
 private:
-    vector<Student*> students;  // Using pointers for dynamic polymorphism
-    vector<User*> users;
-    User* currentUser;
+    struct Chunk {
+        size_t course;  // index into courseNames / groups
+        size_t begin;
+        size_t end;
+    };
     
-    void clearInputBuffer() {
-        cin.clear();
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    }
+    struct Entry {
+        const Student* student;
+        const char* grade;  // under the grading scheme in use
+    };
     
-public:
-    // Constructor
-    ManagementSystem() : currentUser(nullptr) {
-        // Initialize with default users
-        users.push_back(new Admin("admin", "admin123"));
-        users.push_back(new Teacher("teacher1", "teacher123", "Mathematics"));
-        users.push_back(new Teacher("teacher2", "teacher456", "Physics"));
-    }
+    vector<string> courseNames;
+    vector<string> fileStems;    // unique file-safe name per course
+    vector<vector<Entry>> groups;
+    vector<Chunk> chunks;
+    TranscriptFormat format;
+    string outputDir;
     
-    // Destructor - cleanup dynamic memory
-    ~ManagementSystem() {
-        for (auto student : students) {
-            delete student;
+    // Shared state between the renderer threads and the writer
+    vector<string> slots;        // rendered text, indexed by chunk % window
+    vector<size_t> slotChunk;    // which chunk currently fills each slot
+    vector<bool> slotReady;
+    size_t window;
+    size_t written;              // chunks already written to disk
+    bool aborted;
+    std::exception_ptr workerError;  // first failure in a worker, rethrown by generate()
+    std::atomic<size_t> nextChunk;
+    std::mutex mtx;
+    std::condition_variable cv;
+    
+    static string htmlEscape(std::string_view text) {
+        string out;
+        out.reserve(text.size());
+        for (char c : text) {
+            switch (c) {
+                case '&': out += "&amp;"; break;
+                case '<': out += "&lt;"; break;
+                case '>': out += "&gt;"; break;
+                case '"': out += "&quot;"; break;
+                default: out += c;
+            }
         }
-        for (auto user : users) {
-            delete user;
+        return out;
+    }
+    
+    // Keep file names portable: letters and digits only
+    static string fileSafe(const string& text) {
+        string out;
+        for (char c : text) {
+            bool alnum = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+            out += alnum ? c : '_';
         }
+        return out.empty() ? string("unnamed") : out;
     }
     
-    // Login functionality
-    bool login(const string& username, const string& password) {
-        try {
-            for (auto user : users) {
-                if (user->authenticate(username, password)) {
-                    currentUser = user;
-                    cout << "\n✓ Login successful!" << endl;
-                    currentUser->displayInfo();
-                    return true;
-                }
-            }
-            throw InvalidCredentialsException("Invalid username or password");
-        } catch (const InvalidCredentialsException& e) {
-            cout << "\n✗ Error: " << e.what() << endl;
-            return false;
+    static string lowerCase(string text) {
+        for (char& c : text) {
+            if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
         }
+        return text;
     }
     
-    void logout() {
-        currentUser = nullptr;
-        cout << "\n✓ Logged out successfully!" << endl;
+    string fileNameFor(size_t course) const {
+        string dir = outputDir.empty() ? string(".") : outputDir;
+        return dir + "/transcripts_" + fileStems[course] +
+               (format == TranscriptFormat::Html ? ".html" : ".txt");
     }
     
-    // Add new student
-    void addStudent() {
-        if (currentUser == nullptr || currentUser->getRole() != "Admin") {
-            cout << "\n✗ Only Admin can add students!" << endl;
-            return;
+    void renderHtml(ostream& os, const Student& s, const char* grade) const {
+        os << "<div class=\"marksheet\">\n<h2>Statement of Marks</h2>\n"
+           << "<p>Roll Number: " << s.getRollNo() << "<br>Name: " << htmlEscape(s.getName())
+           << "<br>Course: " << htmlEscape(s.getCourse()) << "</p>\n<table>\n";
+        for (int i = 0; i < s.getNumSubjects(); i++) {
+            os << "<tr><td>Subject " << (i + 1) << "</td><td>" << s.getMarks(i) << "</td></tr>\n";
         }
-        
-        try {
-            int roll, subjects;
-            string name, course;
-            
-            cout << "\n╔════════════════════════════════╗" << endl;
-            cout << "║        ADD NEW STUDENT         ║" << endl;
-            cout << "╚════════════════════════════════╝" << endl;
+        os << "</table>\n<p>Average: " << fixed << setprecision(2) << s.getAverage()
+           << "<br>Grade: " << grade << "</p>\n</div>\n";
+    }
+    
+    void renderChunk(const Chunk& chunk, string& out) const {
+        std::ostringstream os;
+        const vector<Entry>& group = groups[chunk.course];
+        for (size_t i = chunk.begin; i < chunk.end; i++) {
+            if (format == TranscriptFormat::Html) {
+                renderHtml(os, *group[i].student, group[i].grade);
+            } else {
+                group[i].student->renderMarksheet(os, group[i].grade);
+                os << string(46, '=') << '\n';
+            }
+        }
+        out = os.str();
+    }
+    
+    void workerLoop() {
+        while (true) {
+            size_t c = nextChunk.fetch_add(1);
+            if (c >= chunks.size()) return;
             
-            cout << "Enter Roll Number: ";
-            cin >> roll;
-            clearInputBuffer();
+            // Wait until the writer has freed this chunk's slot (backpressure)
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [&] { return aborted || c < written + window; });
+                if (aborted) return;
+            }
             
-            // Check if roll number already exists
-            for (auto student : students) {
-                if (student->getRollNo() == roll) {
-                    throw runtime_error("Student with this roll number already exists");
+            string text;
+            try {
+                renderChunk(chunks[c], text);
+            } catch (...) {
+                // An exception must not leave the thread; stop everyone instead
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    if (!workerError) workerError = std::current_exception();
+                    aborted = true;
                 }
+                cv.notify_all();
+                return;
             }
             
-            cout << "Enter Name: ";
-            getline(cin, name);
-            
-            cout << "Enter Course: ";
-            getline(cin, course);
-            
-            cout << "Enter number of subjects (default 5): ";
-            cin >> subjects;
-            clearInputBuffer();
-            
-            if (subjects <= 0) {
-                throw InvalidMarksException("Number of subjects must be positive");
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                size_t slot = c % window;
+                slots[slot].swap(text);
+                slotChunk[slot] = c;
+                slotReady[slot] = true;
             }
-            
-            // Dynamic memory allocation
-            Student* newStudent = new Student(roll, name, course, subjects);
-            students.push_back(newStudent);
-            
-            cout << "\n✓ Student added successfully!" << endl;
-        } catch (const exception& e) {
-            cout << "\n✗ Error: " << e.what() << endl;
+            cv.notify_all();
         }
     }
     
-    // Update student details
-    void updateStudent() {
-        if (currentUser == nullptr || currentUser->getRole() != "Admin") {
-            cout << "\n✗ Only Admin can update student details!" << endl;
-            return;
+    void writeHeader(ostream& os, size_t course) const {
+        if (format == TranscriptFormat::Html) {
+            os << "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>Transcripts - "
+               << htmlEscape(courseNames[course]) << "</title>\n<style>.marksheet{page-break-after:always}"
+               << "</style></head><body>\n";
+        }
+    }
+    
+    void writeFooter(ostream& os) const {
+        if (format == TranscriptFormat::Html) {
+            os << "</body></html>\n";
+        }
+    }
+    
+public:
+    static constexpr size_t CHUNK_SIZE = 2048;
+    
+    TranscriptGenerator(const vector<Student*>& students, GradingScheme scheme, TranscriptFormat fmt,
+                        const string& dir)
+        : format(fmt), outputDir(dir), window(0), written(0), aborted(false), nextChunk(0) {
+        // Grade the whole cohort first: relative grades rank across courses
+        vector<const char*> grades = gradeLabels(students, scheme);
+        // Group by course; std::map keeps the course files in a stable order
+        std::map<string, vector<Entry>> byCourse;
+        for (size_t i = 0; i < students.size(); i++) {
+            byCourse[string(students[i]->getCourse())].push_back({students[i], grades[i]});
+        }
+        for (auto& entry : byCourse) {
+            courseNames.push_back(entry.first);
+            groups.push_back(std::move(entry.second));
+        }
+        // Different courses can map to the same safe name ("C++" and "C--"), and
+        // some file systems ignore case, so later ones get a numeric suffix
+        std::set<string> usedStems;
+        for (auto& course : courseNames) {
+            string base = fileSafe(course);
+            string stem = base;
+            for (int suffix = 2; !usedStems.insert(lowerCase(stem)).second; suffix++) {
+                stem = base + "_" + std::to_string(suffix);
+            }
+            fileStems.push_back(stem);
+        }
+        for (size_t c = 0; c < groups.size(); c++) {
+            for (size_t begin = 0; begin < groups[c].size(); begin += CHUNK_SIZE) {
+                chunks.push_back({c, begin, std::min(begin + CHUNK_SIZE, groups[c].size())});
+            }
+        }
+    }
+    
+    size_t getNumFiles() const { return groups.size(); }
+    
+    // Render and write all transcripts; returns the number of marksheets written
+    size_t generate() {
+        unsigned hw = std::thread::hardware_concurrency();
+        size_t numWorkers = hw > 1 ? hw - 1 : 1;
+        window = numWorkers * 2;
+        slots.assign(window, string());
+        slotChunk.assign(window, 0);
+        slotReady.assign(window, false);
+        written = 0;
+        aborted = false;
+        workerError = nullptr;
+        nextChunk = 0;
+        
+        vector<std::thread> workers;
+        for (size_t i = 0; i < numWorkers; i++) {
+            workers.emplace_back(&TranscriptGenerator::workerLoop, this);
         }
         
+        size_t count = 0;
         try {
-            int roll;
-            cout << "\n╔════════════════════════════════╗" << endl;
-            cout << "║      UPDATE STUDENT DETAILS    ║" << endl;
-            cout << "╚════════════════════════════════╝" << endl;
-            cout << "Enter Roll Number: ";
-            cin >> roll;
-            clearInputBuffer();
-            
-            Student* student = findStudent(roll);
-            if (student == nullptr) {
-                throw StudentNotFoundException("Student not found");
+            std::ofstream out;
+            size_t openCourse = groups.size();
+            for (size_t c = 0; c < chunks.size(); c++) {
+                string text;
+                {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    size_t slot = c % window;
+                    cv.wait(lock, [&] { return aborted || (slotReady[slot] && slotChunk[slot] == c); });
+                    if (aborted) std::rethrow_exception(workerError);
+                    text.swap(slots[slot]);
+                    slotReady[slot] = false;
+                }
+                
+                if (chunks[c].course != openCourse) {
+                    if (out.is_open()) {
+                        writeFooter(out);
+                        out.close();
+                    }
+                    openCourse = chunks[c].course;
+                    out.open(fileNameFor(openCourse), std::ios::out | std::ios::trunc);
+                    if (!out) {
+                        throw runtime_error("Cannot open " + fileNameFor(openCourse));
+                    }
+                    writeHeader(out, openCourse);
+                }
+                out.write(text.data(), static_cast<std::streamsize>(text.size()));
+                if (!out) {
+                    throw runtime_error("Write failed for " + fileNameFor(openCourse));
+                }
+                count += chunks[c].end - chunks[c].begin;
+                
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    written = c + 1;
+                }
+                cv.notify_all();
             }
-            
-            cout << "\nCurrent Details:" << endl;
-            student->displayInfo();
-            
-            cout << "\nWhat do you want to update?" << endl;
-            cout << "1. Name" << endl;
-            cout << "2. Course" << endl;
-            cout << "3. Both" << endl;
-            cout << "Enter choice: ";
-            
-            int choice;
-            cin >> choice;
-            clearInputBuffer();
-            
-            string name, course;
-            
-            switch (choice) {
+            if (out.is_open()) {
+                writeFooter(out);
+            }
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                aborted = true;
+            }
+            cv.notify_all();
+            for (auto& worker : workers) worker.join();
+            throw;
+        }
+        
+        for (auto& worker : workers) worker.join();
+        return count;
+    }
+};
+
+// ==================== ASYNCHRONOUS EXPORT (PRODUCER / WRITER THREADS) ====================
+// Exports a snapshot of the students to CSV in the background.
+// A producer thread formats rows into a small ring of large buffers; a writer
+// thread hands each full buffer to the OS with pwrite() at its file offset and
+// returns it to the ring. When all buffers are full the producer waits
+// (backpressure), so memory use is fixed at NUM_BUFFERS * BUFFER_SIZE.
+// Progress counters are atomics that the menu can read at any time.
+class AsyncExporter {
+public:
+    enum class State { Running, Done, Failed };
+    
+    static constexpr size_t NUM_BUFFERS = 4;
+    static constexpr size_t BUFFER_SIZE = 8 * 1024 * 1024;
+    
+private:
+    // Copy of the data taken when the export starts, so the session can keep
+    // editing students while the export runs
+    struct Row {
+        int rollNo;
+        string name;
+        string course;
+        size_t firstMark;   // marks live in one flat array, see allMarks
+        int numMarks;
+        double average;
+        const char* grade;  // policy label (static storage) under the scheme in use
+    };
+    
+    struct Filled {
+        size_t buffer;
+        size_t length;
+    };
+    
+    vector<Row> rows;
+    vector<int> allMarks;
+    string path;
+    vector<vector<char>> buffers;
+    std::deque<size_t> freeBuffers;
+    std::deque<Filled> fullBuffers;
+    bool producerDone;
+    bool writerFailed;
+    std::mutex mtx;
+    std::condition_variable cv;
+    
+    std::atomic<size_t> rowsFormatted;
+    std::atomic<unsigned long long> bytesWritten;
+    std::atomic<int> state;
+    string errorMessage;
+    
+    std::thread producer;
+    std::thread writer;
+    
+    static void appendCsvField(vector<char>& out, size_t& len, const string& field) {
+        bool quote = field.find_first_of(",\"\r\n") != string::npos;
+        if (quote) out[len++] = '"';
+        for (char c : field) {
+            if (c == '"') out[len++] = '"';
+            out[len++] = c;
+        }
+        if (quote) out[len++] = '"';
+    }
+    
+    static void appendInt(vector<char>& out, size_t& len, int value) {
+        auto result = std::to_chars(out.data() + len, out.data() + out.size(), value);
+        len = static_cast<size_t>(result.ptr - out.data());
+    }
+    
+    // Upper bound on the bytes a row can take, so formatting never overflows
+    static size_t maxRowBytes(const Row& row) {
+        return 64 + 2 * (row.name.size() + row.course.size()) + 12 * static_cast<size_t>(row.numMarks);
+    }
+    
+    size_t formatRow(const Row& row, vector<char>& out, size_t len) const {
+        appendInt(out, len, row.rollNo);
+        out[len++] = ',';
+        appendCsvField(out, len, row.name);
+        out[len++] = ',';
+        appendCsvField(out, len, row.course);
+        len += std::snprintf(out.data() + len, out.size() - len, ",%.2f,", row.average);
+        appendCsvField(out, len, row.grade);
+        for (int i = 0; i < row.numMarks; i++) {
+            out[len++] = ',';
+            appendInt(out, len, allMarks[row.firstMark + i]);
+        }
+        out[len++] = '\n';
+        return len;
+    }
+    
+    size_t acquireBuffer() {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [&] { return !freeBuffers.empty() || writerFailed; });
+        if (writerFailed) return NUM_BUFFERS;
+        size_t b = freeBuffers.front();
+        freeBuffers.pop_front();
+        return b;
+    }
+    
+    void submitBuffer(size_t b, size_t len) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            fullBuffers.push_back({b, len});
+        }
+        cv.notify_all();
+    }
+    
+    void produce() {
+        size_t b = acquireBuffer();
+        size_t len = 0;
+        const char header[] = "roll_no,name,course,average,grade,marks...\n";
+        if (b < NUM_BUFFERS) {
+            std::copy(header, header + sizeof(header) - 1, buffers[b].data());
+            len = sizeof(header) - 1;
+        }
+        
+        for (size_t i = 0; i < rows.size() && b < NUM_BUFFERS; i++) {
+            if (len + maxRowBytes(rows[i]) > BUFFER_SIZE) {
+                submitBuffer(b, len);
+                b = acquireBuffer();
+                len = 0;
+                if (b >= NUM_BUFFERS) break;
+                // A single enormous row gets a buffer of its own
+                if (maxRowBytes(rows[i]) > buffers[b].size()) {
+                    buffers[b].resize(maxRowBytes(rows[i]));
+                }
+            }
+            len = formatRow(rows[i], buffers[b], len);
+            rowsFormatted++;
+        }
+        if (b < NUM_BUFFERS && len > 0) {
+            submitBuffer(b, len);
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            producerDone = true;
+        }
+        cv.notify_all();
+    }
+    
+    void fail(const string& message) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            errorMessage = message;
+            writerFailed = true;
+        }
+        state = static_cast<int>(State::Failed);
+        cv.notify_all();
+    }
+    
+    void writeAll() {
+#if SMS_HAVE_POSIX
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            fail("Cannot open " + path);
+            return;
+        }
+#else
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+            fail("Cannot open " + path);
+            return;
+        }
+#endif
+        unsigned long long offset = 0;
+        while (true) {
+            Filled next;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [&] { return !fullBuffers.empty() || producerDone; });
+                if (fullBuffers.empty()) break;
+                next = fullBuffers.front();
+                fullBuffers.pop_front();
+            }
+            
+            const char* data = buffers[next.buffer].data();
+            size_t remaining = next.length;
+            bool ok = true;
+            while (remaining > 0) {
+#if SMS_HAVE_POSIX
+                ssize_t n = ::pwrite(fd, data, remaining, static_cast<off_t>(offset));
+                if (n < 0 && errno == EINTR) continue;
+#else
+                long n = static_cast<long>(std::fwrite(data, 1, remaining, file));
+#endif
+                if (n <= 0) {
+                    ok = false;
+                    break;
+                }
+                data += n;
+                remaining -= static_cast<size_t>(n);
+                offset += static_cast<unsigned long long>(n);
+                bytesWritten += static_cast<unsigned long long>(n);
+            }
+            if (!ok) {
+                fail("Write failed for " + path);
+                break;
+            }
+            
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                freeBuffers.push_back(next.buffer);
+            }
+            cv.notify_all();
+        }
+#if SMS_HAVE_POSIX
+        ::close(fd);
+#else
+        std::fclose(file);
+#endif
+        if (state == static_cast<int>(State::Running)) {
+            state = static_cast<int>(State::Done);
+        }
+    }
+    
+public:
+    // Snapshot the students on the calling thread, then return immediately
+    AsyncExporter(const vector<Student*>& students, GradingScheme scheme, const string& file)
+        : path(file), producerDone(false), writerFailed(false),
+          rowsFormatted(0), bytesWritten(0), state(static_cast<int>(State::Running)) {
+        vector<const char*> grades = gradeLabels(students, scheme);
+        rows.reserve(students.size());
+        for (size_t s = 0; s < students.size(); s++) {
+            const Student* student = students[s];
+            Row row;
+            row.rollNo = student->getRollNo();
+            row.name = student->getName();
+            row.course = student->getCourse();
+            row.firstMark = allMarks.size();
+            row.numMarks = student->getNumSubjects();
+            for (int i = 0; i < row.numMarks; i++) {
+                allMarks.push_back(student->getMarks(i));
+            }
+            row.average = student->getAverage();
+            row.grade = grades[s];
+            rows.push_back(std::move(row));
+        }
+        
+        buffers.assign(NUM_BUFFERS, vector<char>(BUFFER_SIZE));
+        for (size_t b = 0; b < NUM_BUFFERS; b++) {
+            freeBuffers.push_back(b);
+        }
+        writer = std::thread(&AsyncExporter::writeAll, this);
+        producer = std::thread(&AsyncExporter::produce, this);
+    }
+    
+    // Waits for the export to finish; the data must reach the file
+    ~AsyncExporter() {
+        if (producer.joinable()) producer.join();
+        if (writer.joinable()) writer.join();
+    }
+    
+    AsyncExporter(const AsyncExporter&) = delete;
+    AsyncExporter& operator=(const AsyncExporter&) = delete;
+    
+    State getState() const { return static_cast<State>(state.load()); }
+    size_t getTotalRows() const { return rows.size(); }
+    size_t getRowsFormatted() const { return rowsFormatted; }
+    unsigned long long getBytesWritten() const { return bytesWritten; }
+    const string& getPath() const { return path; }
+    
+    string getError() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return errorMessage;
+    }
+};
+
+// ==================== CHANGE-DATA-CAPTURE FEED (LOCK-FREE RING) ====================
+// Every mutation (add, update, marks) becomes a ChangeEvent. The menu thread
+// pushes events into a lock-free single-producer/single-consumer ring and
+// carries on; a publisher thread drains the ring and appends each event in a
+// compact binary form to a log file. Subscribers read the log from any byte
+// offset, either by tailing the file or over a Unix socket, so a slow
+// subscriber only ever delays itself.
+//
+// Log record layout (little-endian):
+//   u32 length of the rest of the record
+//   u64 sequence, u64 time (microseconds since epoch), u8 type, i32 roll no
+//   u16 + bytes name, u16 + bytes course, u8 count + u8 marks
+// A subscriber resumes by passing the offset just after the last record it handled.
+
+// Template class: fixed-capacity ring for exactly one producer and one consumer.
+// Each index is written by one side only, so plain atomics are enough.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    
+private:
+    std::array<T, Capacity> slots;
+    alignas(64) std::atomic<size_t> head;  // next slot to read (consumer)
+    alignas(64) std::atomic<size_t> tail;  // next slot to write (producer)
+    
+public:
+    SpscRing() : head(0), tail(0) {}
+    
+    bool tryPush(T&& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) return false;
+        slots[t & (Capacity - 1)] = std::move(item);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    
+    bool tryPop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        item = std::move(slots[h & (Capacity - 1)]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+enum class ChangeType : unsigned char { StudentAdded = 1, StudentUpdated = 2, MarksEntered = 3 };
+
+struct ChangeEvent {
+    unsigned long long sequence = 0;
+    unsigned long long timeMicros = 0;
+    ChangeType type = ChangeType::StudentAdded;
+    int rollNo = 0;
+    string name;
+    string course;
+    vector<unsigned char> marks;
+    
+    static ChangeEvent fromStudent(ChangeType type, const Student& s) {
+        ChangeEvent event;
+        event.type = type;
+        event.rollNo = s.getRollNo();
+        if (type != ChangeType::MarksEntered) {
+            event.name = s.getName();
+            event.course = s.getCourse();
+        }
+        if (type != ChangeType::StudentUpdated) {
+            for (int i = 0; i < s.getNumSubjects(); i++) {
+                event.marks.push_back(static_cast<unsigned char>(s.getMarks(i)));
+            }
+        }
+        return event;
+    }
+    
+    const char* typeName() const {
+        switch (type) {
+            case ChangeType::StudentAdded: return "ADDED";
+            case ChangeType::StudentUpdated: return "UPDATED";
+            case ChangeType::MarksEntered: return "MARKS";
+        }
+        return "UNKNOWN";
+    }
+};
+
+namespace cdc {
+    inline void putInt(string& out, unsigned long long value, int bytes) {
+        for (int i = 0; i < bytes; i++) {
+            out += static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+    
+    inline unsigned long long getInt(const unsigned char* in, int bytes) {
+        unsigned long long value = 0;
+        for (int i = 0; i < bytes; i++) {
+            value |= static_cast<unsigned long long>(in[i]) << (8 * i);
+        }
+        return value;
+    }
+    
+    inline void putText(string& out, const string& text) {
+        size_t len = std::min<size_t>(text.size(), 0xFFFF);
+        putInt(out, len, 2);
+        out.append(text, 0, len);
+    }
+    
+    inline string encode(const ChangeEvent& event) {
+        string body;
+        putInt(body, event.sequence, 8);
+        putInt(body, event.timeMicros, 8);
+        putInt(body, static_cast<unsigned char>(event.type), 1);
+        putInt(body, static_cast<unsigned int>(event.rollNo), 4);
+        putText(body, event.name);
+        putText(body, event.course);
+        size_t numMarks = std::min<size_t>(event.marks.size(), 0xFF);
+        putInt(body, numMarks, 1);
+        body.append(reinterpret_cast<const char*>(event.marks.data()), numMarks);
+        
+        string record;
+        putInt(record, body.size(), 4);
+        return record + body;
+    }
+    
+    // Decodes one record from [data, data + size). Returns the record's total
+    // size, or 0 if the buffer does not yet hold a complete record.
+    inline size_t decode(const unsigned char* data, size_t size, ChangeEvent& event) {
+        if (size < 4) return 0;
+        size_t length = static_cast<size_t>(getInt(data, 4));
+        if (size < 4 + length || length < 26) return 0;
+        const unsigned char* p = data + 4;
+        const unsigned char* end = p + length;
+        event.sequence = getInt(p, 8);
+        event.timeMicros = getInt(p + 8, 8);
+        event.type = static_cast<ChangeType>(p[16]);
+        event.rollNo = static_cast<int>(static_cast<unsigned int>(getInt(p + 17, 4)));
+        p += 21;
+        size_t nameLen = static_cast<size_t>(getInt(p, 2));
+        p += 2;
+        if (p + nameLen + 2 > end) throw runtime_error("Corrupt change record");
+        event.name.assign(reinterpret_cast<const char*>(p), nameLen);
+        p += nameLen;
+        size_t courseLen = static_cast<size_t>(getInt(p, 2));
+        p += 2;
+        if (p + courseLen + 1 > end) throw runtime_error("Corrupt change record");
+        event.course.assign(reinterpret_cast<const char*>(p), courseLen);
+        p += courseLen;
+        size_t numMarks = *p++;
+        if (p + numMarks > end) throw runtime_error("Corrupt change record");
+        event.marks.assign(p, p + numMarks);
+        return 4 + length;
+    }
+}
+
+#if SMS_HAVE_POSIX
+// Socket address for a filesystem path (shared with the sharding layer)
+inline sockaddr_un unixAddress(const string& path) {
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        throw runtime_error("Socket path too long: " + path);
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return addr;
+}
+
+class ChangeFeed {
+private:
+    static constexpr size_t RING_CAPACITY = 4096;
+    
+    SpscRing<ChangeEvent, RING_CAPACITY> ring;
+    string logPath;
+    string socketPath;
+    int logFd;
+    int listenFd;
+    unsigned long long nextSequence;                // producer side only
+    std::atomic<unsigned long long> committedBytes; // complete records in the log
+    std::atomic<bool> stopping;
+    std::atomic<bool> failed;                       // the log could not be written
+    std::thread publisher;
+    std::thread acceptor;
+    
+    // The feed owns each subscriber's socket: it is shut down to unblock the
+    // thread on exit and closed only after the thread has been joined
+    struct Subscriber {
+        int fd;
+        std::atomic<bool> done;
+        std::thread thread;
+        explicit Subscriber(int socket) : fd(socket), done(false) {}
+    };
+    std::mutex subscriberMtx;
+    vector<std::unique_ptr<Subscriber>> subscribers;
+    
+    static unsigned long long nowMicros() {
+        return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+    
+    // Walks an existing log to find where it ends and the last sequence number.
+    // A partial record left by a crash is cut off.
+    void recoverLog() {
+        unsigned long long offset = 0;
+        unsigned char header[12];
+        while (::pread(logFd, header, sizeof(header), static_cast<off_t>(offset)) == static_cast<ssize_t>(sizeof(header))) {
+            unsigned long long length = cdc::getInt(header, 4);
+            struct stat info;
+            if (::fstat(logFd, &info) != 0 || offset + 4 + length > static_cast<unsigned long long>(info.st_size)) {
+                break;
+            }
+            nextSequence = cdc::getInt(header + 4, 8) + 1;
+            offset += 4 + length;
+        }
+        if (::ftruncate(logFd, static_cast<off_t>(offset)) != 0) {
+            throw runtime_error("Cannot repair change log " + logPath);
+        }
+        committedBytes = offset;
+    }
+    
+    // Drains the ring into the log, batching whatever has accumulated
+    void publishLoop() {
+        string batch;
+        ChangeEvent event;
+        while (true) {
+            batch.clear();
+            while (batch.size() < 1024 * 1024 && ring.tryPop(event)) {
+                batch += cdc::encode(event);
+            }
+            if (batch.empty()) {
+                if (stopping) return;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            unsigned long long offset = committedBytes;
+            size_t written = 0;
+            while (written < batch.size()) {
+                ssize_t n = ::pwrite(logFd, batch.data() + written, batch.size() - written,
+                                     static_cast<off_t>(offset + written));
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) {
+                    std::cerr << "Change feed: write to " << logPath << " failed" << endl;
+                    failed = true;
+                    return;
+                }
+                written += static_cast<size_t>(n);
+            }
+            committedBytes = offset + written;
+        }
+    }
+    
+    static bool sendAll(int fd, const char* data, size_t size) {
+#ifdef MSG_NOSIGNAL
+        const int flags = MSG_NOSIGNAL;
+#else
+        const int flags = 0;
+#endif
+        while (size > 0) {
+            ssize_t n = ::send(fd, data, size, flags);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+    
+    // Waits up to 100 ms for the socket to become ready, so callers can
+    // check the stop flag between waits
+    static bool waitFor(int fd, short events) {
+        pollfd entry = {fd, events, 0};
+        int n = ::poll(&entry, 1, 100);
+        return n > 0;
+    }
+    
+    // One thread per subscriber: reads the start offset, then streams the log
+    // from there and keeps following it as it grows
+    void serveSubscriber(Subscriber* subscriber) {
+        int fd = subscriber->fd;
+        string request;
+        bool gotRequest = false;
+        while (!stopping && request.size() < 32) {
+            if (!waitFor(fd, POLLIN)) continue;
+            char c;
+            ssize_t n = ::read(fd, &c, 1);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0 || c == '\n') {
+                gotRequest = n == 1;
+                break;
+            }
+            request += c;
+        }
+        
+        unsigned long long offset = 0;
+        bool valid = gotRequest;
+        try {
+            offset = request.empty() ? 0 : std::stoull(request);
+        } catch (const exception&) {
+            valid = false;
+        }
+        
+        vector<char> buffer(256 * 1024);
+        while (valid && !stopping) {
+            unsigned long long end = committedBytes;
+            if (offset >= end) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            if (!waitFor(fd, POLLOUT)) continue;  // subscriber is not reading
+            size_t want = static_cast<size_t>(std::min<unsigned long long>(end - offset, buffer.size()));
+            ssize_t n = ::pread(logFd, buffer.data(), want, static_cast<off_t>(offset));
+            if (n <= 0 || !sendAll(fd, buffer.data(), static_cast<size_t>(n))) break;
+            offset += static_cast<unsigned long long>(n);
+        }
+        subscriber->done = true;
+    }
+    
+    // Joins and closes subscribers whose threads have returned
+    void reapSubscribers() {
+        for (size_t i = 0; i < subscribers.size();) {
+            if (subscribers[i]->done) {
+                subscribers[i]->thread.join();
+                ::close(subscribers[i]->fd);
+                subscribers[i] = std::move(subscribers.back());
+                subscribers.pop_back();
+            } else {
+                i++;
+            }
+        }
+    }
+    
+    void acceptLoop() {
+        while (!stopping) {
+            if (!waitFor(listenFd, POLLIN)) {
+                std::lock_guard<std::mutex> lock(subscriberMtx);
+                reapSubscribers();
+                continue;
+            }
+            int fd = ::accept(listenFd, nullptr, nullptr);
+            if (fd < 0) {
+                if (errno == EINTR || errno == EAGAIN) continue;
+                return;
+            }
+            std::lock_guard<std::mutex> lock(subscriberMtx);
+            reapSubscribers();
+            if (stopping) {
+                ::close(fd);
+                return;
+            }
+            subscribers.emplace_back(new Subscriber(fd));
+            Subscriber* subscriber = subscribers.back().get();
+            subscriber->thread = std::thread(&ChangeFeed::serveSubscriber, this, subscriber);
+        }
+    }
+    
+public:
+    // socket may be empty to publish to the log file only
+    ChangeFeed(const string& log, const string& socket)
+        : logPath(log), socketPath(socket), logFd(-1), listenFd(-1),
+          nextSequence(1), committedBytes(0), stopping(false), failed(false) {
+        logFd = ::open(logPath.c_str(), O_RDWR | O_CREAT, 0644);
+        if (logFd < 0) throw runtime_error("Cannot open change log " + logPath);
+        try {
+            recoverLog();
+            if (!socketPath.empty()) {
+                listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+                sockaddr_un addr = unixAddress(socketPath);
+                ::unlink(socketPath.c_str());
+                if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+                    ::listen(listenFd, 16) < 0) {
+                    throw runtime_error("Cannot listen on " + socketPath);
+                }
+            }
+        } catch (...) {
+            if (listenFd >= 0) ::close(listenFd);
+            ::close(logFd);
+            throw;
+        }
+        publisher = std::thread(&ChangeFeed::publishLoop, this);
+        if (listenFd >= 0) {
+            acceptor = std::thread(&ChangeFeed::acceptLoop, this);
+        }
+    }
+    
+    // Publishes everything still in the ring, then stops all threads.
+    // Subscriber sockets are shut down so a stalled subscriber cannot hold
+    // up exit.
+    ~ChangeFeed() {
+        stopping = true;
+        publisher.join();
+        if (listenFd >= 0) {
+            ::shutdown(listenFd, SHUT_RDWR);
+            acceptor.join();
+            ::close(listenFd);
+            ::unlink(socketPath.c_str());
+        }
+        std::lock_guard<std::mutex> lock(subscriberMtx);
+        for (auto& subscriber : subscribers) ::shutdown(subscriber->fd, SHUT_RDWR);
+        for (auto& subscriber : subscribers) {
+            subscriber->thread.join();
+            ::close(subscriber->fd);
+        }
+        ::close(logFd);
+    }
+    
+    ChangeFeed(const ChangeFeed&) = delete;
+    ChangeFeed& operator=(const ChangeFeed&) = delete;
+    
+    // Called on the menu thread; never waits for subscribers. Only if the
+    // publisher has fallen 4096 events behind does it yield until a slot frees.
+    // Returns false (and drops the event) once the log can no longer be written.
+    bool record(ChangeEvent event) {
+        if (failed) return false;
+        event.sequence = nextSequence++;
+        event.timeMicros = nowMicros();
+        while (!ring.tryPush(std::move(event))) {
+            if (failed) return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+    
+    bool hasFailed() const { return failed; }
+    
+    const string& getLogPath() const { return logPath; }
+    const string& getSocketPath() const { return socketPath; }
+    unsigned long long getCommittedBytes() const { return committedBytes; }
+    unsigned long long getNextSequence() const { return nextSequence; }
+};
+
+// Connects to a change feed socket and prints events from the given offset
+int runChangeFeedTail(const string& socketPath, unsigned long long offset) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr = unixAddress(socketPath);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        cout << "✗ Error: cannot connect to " << socketPath << endl;
+        if (fd >= 0) ::close(fd);
+        return 1;
+    }
+    string request = std::to_string(offset) + "\n";
+    if (::write(fd, request.data(), request.size()) != static_cast<ssize_t>(request.size())) {
+        ::close(fd);
+        return 1;
+    }
+    
+    vector<unsigned char> pending;
+    unsigned char chunk[64 * 1024];
+    ssize_t n;
+    while ((n = ::read(fd, chunk, sizeof(chunk))) > 0) {
+        pending.insert(pending.end(), chunk, chunk + n);
+        size_t used = 0;
+        ChangeEvent event;
+        size_t size;
+        while ((size = cdc::decode(pending.data() + used, pending.size() - used, event)) > 0) {
+            used += size;
+            offset += size;
+            cout << "resume@" << offset << " #" << event.sequence << ' ' << event.typeName()
+                 << " roll=" << event.rollNo;
+            if (!event.name.empty()) cout << " name=\"" << event.name << "\" course=\"" << event.course << '"';
+            if (!event.marks.empty()) {
+                cout << " marks=";
+                for (size_t i = 0; i < event.marks.size(); i++) {
+                    cout << (i ? "," : "") << static_cast<int>(event.marks[i]);
+                }
+            }
+            cout << endl;
+        }
+        pending.erase(pending.begin(), pending.begin() + static_cast<long>(used));
+    }
+    ::close(fd);
+    return 0;
+}
+#endif
+
+// ==================== EXAM CLASS ====================
+class Exam {
+private:
+    string examName;
+    string examDate;
+    int totalMarks;
+    string course;   // course whose students sit this paper
+    int subject;     // subject index within the course
+    
+public:
+    Exam(const string& name, const string& date, int marks, const string& c = "", int subj = 0) 
+        : examName(name), examDate(date), totalMarks(marks), course(c), subject(subj) {}
+    
+    void displayExamInfo() const {
+        cout << "\n╔════════════════════════════════╗" << endl;
+        cout << "║        EXAM DETAILS            ║" << endl;
+        cout << "╚════════════════════════════════╝" << endl;
+        cout << "Exam Name: " << examName << endl;
+        cout << "Date: " << examDate << endl;
+        cout << "Total Marks: " << totalMarks << endl;
+    }
+    
+    string getExamName() const { return examName; }
+    string getExamDate() const { return examDate; }
+    string getCourse() const { return course; }
+    int getSubject() const { return subject; }
+    int getTotalMarks() const { return totalMarks; }
+    void setExamDate(const string& date) { examDate = date; }
+};
+
+// ==================== EXAM SCHEDULING & SEATING ====================
+struct Room {
+    string name;
+    int capacity;
+};
+
+// Which papers each student sits, stored compactly (one flat array plus an
+// offset per student) so a million students cost two allocations
+struct Enrollment {
+    vector<size_t> offsets{0};
+    vector<int> papers;
+    
+    void addStudent(const vector<int>& studentPapers) {
+        papers.insert(papers.end(), studentPapers.begin(), studentPapers.end());
+        offsets.push_back(papers.size());
+    }
+    
+    size_t numStudents() const { return offsets.size() - 1; }
+};
+
+// A block of consecutive seats in one room for one paper
+struct SeatBlock {
+    int paper;
+    int room;
+    int firstSeat;
+    int count;
+};
+
+// Builds a timetable without clashes and a seating plan.
+// 1. Papers that share at least one student conflict; the conflict graph is
+//    kept as one bitset row per paper.
+// 2. Greedy colouring (largest degree first) puts each paper in the first time
+//    slot where it has no conflicting paper and the rooms still have seats.
+// 3. Each slot's papers are poured into the rooms in order, so seating is a
+//    handful of SeatBlocks per paper rather than one record per student.
+class ExamScheduler {
+private:
+    size_t numPapers;
+    size_t words;                        // 64-bit words per bitset row
+    vector<unsigned long long> conflicts;
+    vector<int> paperSize;
+    vector<int> paperSlot;
+    vector<vector<SeatBlock>> slotSeating;
+    vector<Room> rooms;
+    long totalSeats;
+    
+    unsigned long long* row(size_t paper) { return &conflicts[paper * words]; }
+    
+    static size_t popcount(const unsigned long long* bits, size_t n) {
+        size_t count = 0;
+        for (size_t w = 0; w < n; w++) count += std::bitset<64>(bits[w]).count();
+        return count;
+    }
+    
+public:
+    ExamScheduler(size_t papers, const vector<Room>& examRooms)
+        : numPapers(papers), words((papers + 63) / 64), conflicts(papers * ((papers + 63) / 64), 0),
+          paperSize(papers, 0), paperSlot(papers, -1), rooms(examRooms), totalSeats(0) {
+        for (auto& room : rooms) totalSeats += room.capacity;
+    }
+    
+    // Step 1: paper sizes and the conflict graph
+    void buildConflicts(const Enrollment& enrollment) {
+        for (size_t s = 0; s < enrollment.numStudents(); s++) {
+            size_t begin = enrollment.offsets[s];
+            size_t end = enrollment.offsets[s + 1];
+            for (size_t i = begin; i < end; i++) {
+                int a = enrollment.papers[i];
+                paperSize[a]++;
+                for (size_t j = i + 1; j < end; j++) {
+                    int b = enrollment.papers[j];
+                    if (a == b) continue;
+                    row(a)[b / 64] |= 1ULL << (b % 64);
+                    row(b)[a / 64] |= 1ULL << (a % 64);
+                }
+            }
+        }
+    }
+    
+    // Step 2: returns the number of time slots used
+    int colour() {
+        vector<int> order(numPapers);
+        vector<size_t> degree(numPapers);
+        for (size_t p = 0; p < numPapers; p++) {
+            order[p] = static_cast<int>(p);
+            degree[p] = popcount(row(p), words);
+        }
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return degree[a] != degree[b] ? degree[a] > degree[b] : paperSize[a] > paperSize[b];
+        });
+        
+        vector<unsigned long long> slotMembers;  // one bitset row per slot
+        vector<long> slotSeats;
+        for (int p : order) {
+            if (paperSize[p] == 0) continue;
+            if (paperSize[p] > totalSeats) {
+                throw runtime_error("A paper has more candidates than all rooms together can seat");
+            }
+            const unsigned long long* conflictRow = row(static_cast<size_t>(p));
+            size_t slot = 0;
+            for (; slot < slotSeats.size(); slot++) {
+                if (slotSeats[slot] + paperSize[p] > totalSeats) continue;
+                const unsigned long long* members = &slotMembers[slot * words];
+                bool clash = false;
+                for (size_t w = 0; w < words && !clash; w++) {
+                    clash = (conflictRow[w] & members[w]) != 0;
+                }
+                if (!clash) break;
+            }
+            if (slot == slotSeats.size()) {
+                slotMembers.resize(slotMembers.size() + words, 0);
+                slotSeats.push_back(0);
+            }
+            slotMembers[slot * words + p / 64] |= 1ULL << (p % 64);
+            slotSeats[slot] += paperSize[p];
+            paperSlot[p] = static_cast<int>(slot);
+        }
+        return static_cast<int>(slotSeats.size());
+    }
+    
+    // Step 3: fill the rooms of every slot, largest paper first
+    void assignSeats(int numSlots) {
+        vector<vector<int>> slotPapers(numSlots);
+        for (size_t p = 0; p < numPapers; p++) {
+            if (paperSlot[p] >= 0) slotPapers[paperSlot[p]].push_back(static_cast<int>(p));
+        }
+        slotSeating.assign(numSlots, vector<SeatBlock>());
+        for (int slot = 0; slot < numSlots; slot++) {
+            std::sort(slotPapers[slot].begin(), slotPapers[slot].end(),
+                      [&](int a, int b) { return paperSize[a] > paperSize[b]; });
+            size_t room = 0;
+            int seat = 0;
+            for (int p : slotPapers[slot]) {
+                int remaining = paperSize[p];
+                while (remaining > 0) {
+                    int free = rooms[room].capacity - seat;
+                    if (free <= 0) {
+                        room++;
+                        seat = 0;
+                        continue;
+                    }
+                    int count = std::min(free, remaining);
+                    slotSeating[slot].push_back({p, static_cast<int>(room), seat, count});
+                    seat += count;
+                    remaining -= count;
+                }
+            }
+        }
+    }
+    
+    // Runs all three steps; returns the number of time slots
+    int schedule(const Enrollment& enrollment) {
+        buildConflicts(enrollment);
+        int numSlots = colour();
+        assignSeats(numSlots);
+        return numSlots;
+    }
+    
+    // True if no student has two papers in the same slot
+    bool verify(const Enrollment& enrollment) const {
+        for (size_t s = 0; s < enrollment.numStudents(); s++) {
+            for (size_t i = enrollment.offsets[s]; i < enrollment.offsets[s + 1]; i++) {
+                for (size_t j = i + 1; j < enrollment.offsets[s + 1]; j++) {
+                    if (enrollment.papers[i] != enrollment.papers[j] &&
+                        paperSlot[enrollment.papers[i]] == paperSlot[enrollment.papers[j]]) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+    
+    int getSlot(int paper) const { return paperSlot[paper]; }
+    int getPaperSize(int paper) const { return paperSize[paper]; }
+    const vector<SeatBlock>& getSeating(int slot) const { return slotSeating[slot]; }
+    const Room& getRoom(int room) const { return rooms[room]; }
+    
+    // Two sessions a day: slot 0 is Day 1 Morning, slot 1 is Day 1 Afternoon...
+    static string slotLabel(int slot) {
+        return "Day " + std::to_string(slot / 2 + 1) + (slot % 2 == 0 ? " Morning" : " Afternoon");
+    }
+};
+
+// Generates a university-sized enrollment and times each scheduling step.
+// Students belong to programmes of 8 papers and take 4 of them plus 1 elective
+// from another programme of the same faculty (10 programmes per faculty).
+int runScheduleBenchmark(size_t numStudents, size_t numPapers, size_t numRooms) {
+    typedef std::chrono::steady_clock Clock;
+    auto millis = [](Clock::time_point since) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+    };
+    if (numPapers < 8 || numRooms == 0) {
+        cout << "✗ Error: need at least 8 papers and 1 room" << endl;
+        return 1;
+    }
+    
+    auto start = Clock::now();
+    unsigned int seed = 2024;
+    auto next = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return seed >> 8;
+    };
+    size_t programmes = numPapers / 8;
+    Enrollment enrollment;
+    enrollment.offsets.reserve(numStudents + 1);
+    enrollment.papers.reserve(numStudents * 5);
+    vector<int> papers;
+    for (size_t s = 0; s < numStudents; s++) {
+        papers.clear();
+        int base = static_cast<int>((next() % programmes) * 8);
+        int first = static_cast<int>(next() % 8);
+        for (int k = 0; k < 4; k++) {
+            papers.push_back(base + (first + k * 2) % 8);
+        }
+        size_t faculty = (base / 8) / 10 * 10;
+        size_t facultySize = std::min<size_t>(10, programmes - faculty);
+        // Elective from anywhere in the faculty, redrawn if it is one of the
+        // student's core papers (the other half of the programme is always free)
+        int elective;
+        do {
+            elective = static_cast<int>((faculty + next() % facultySize) * 8 + next() % 8);
+        } while (std::find(papers.begin(), papers.end(), elective) != papers.end());
+        papers.push_back(elective);
+        enrollment.addStudent(papers);
+    }
+    vector<Room> rooms;
+    for (size_t r = 0; r < numRooms; r++) {
+        rooms.push_back({"Room " + std::to_string(r + 1), 60 + static_cast<int>(next() % 5) * 60});
+    }
+    cout << "Generated " << numStudents << " students, " << numPapers << " papers, "
+         << numRooms << " rooms in " << fixed << setprecision(1) << millis(start) << " ms" << endl;
+    
+    long seats = 0;
+    for (auto& room : rooms) seats += room.capacity;
+    long lowerBound = static_cast<long>((enrollment.papers.size() + seats - 1) / seats);
+    
+    ExamScheduler scheduler(numPapers, rooms);
+    start = Clock::now();
+    scheduler.buildConflicts(enrollment);
+    cout << "Conflict graph:  " << millis(start) << " ms" << endl;
+    start = Clock::now();
+    int numSlots = scheduler.colour();
+    cout << "Colouring:       " << millis(start) << " ms (" << numSlots << " slots, seat capacity needs at least "
+         << lowerBound << ")" << endl;
+    start = Clock::now();
+    scheduler.assignSeats(numSlots);
+    cout << "Seat assignment: " << millis(start) << " ms" << endl;
+    
+    bool ok = scheduler.verify(enrollment);
+    cout << (ok ? "✓ No student has two exams in one slot" : "✗ Clash found!") << endl;
+    return ok ? 0 : 1;
+}
+
+// ==================== ANALYTICS QUERY ENGINE (COLUMNAR, BATCHED) ====================
+// A small query engine for result analytics. Queries run over a columnar copy
+// of the students, one batch of rows at a time: each filter narrows a
+// selection vector (the row numbers still alive in the batch), and the
+// surviving rows are fed into per-group aggregates.
+//
+// Query syntax (words separated by spaces):
+//   [where <cond> [and <cond>]...] [by course|grade] [<aggregate>...]
+//   cond:      course=CS  grade=A  avg>=60  mark3<35  anymark<35
+//              (operators = != < <= > >=; marks are numbered from 1)
+//   aggregate: count  avg(x)  min(x)  max(x)  p90(x)  passrate(x[,50])
+//              where x is avg or markN
+// With no aggregates the matching students are listed.
+
+// Columnar copy of the student store
+struct StudentColumns {
+    static constexpr unsigned char NO_MARK = 255;  // subject not taken
+    
+    vector<int> rollNo;
+    vector<unsigned short> courseId;
+    vector<double> average;
+    vector<unsigned char> grade;            // AbsoluteGrading code
+    vector<vector<unsigned char>> marks;    // marks[subject][row]
+    vector<string> courseNames;             // indexed by courseId
+    vector<const Student*> source;
+    
+    size_t size() const { return rollNo.size(); }
+    
+    void build(const vector<Student*>& students) {
+        size_t n = students.size();
+        int maxSubjects = 0;
+        for (auto student : students) maxSubjects = std::max(maxSubjects, student->getNumSubjects());
+        
+        rollNo.resize(n);
+        courseId.resize(n);
+        average.resize(n);
+        grade.resize(n);
+        marks.assign(maxSubjects, vector<unsigned char>(n, NO_MARK));
+        courseNames.clear();
+        source.assign(students.begin(), students.end());
+        
+        // Course ids come straight from the string pool
+        const StringPool& pool = StringPool::global();
+        for (size_t id = 0; id < pool.numCourses(); id++) {
+            courseNames.push_back(string(pool.course(static_cast<unsigned short>(id))));
+        }
+        for (size_t r = 0; r < n; r++) {
+            const Student* s = students[r];
+            rollNo[r] = s->getRollNo();
+            courseId[r] = s->getCourseId();
+            average[r] = s->getAverage();
+            grade[r] = GradeTable<AbsoluteGrading>::code(average[r]);
+            for (int j = 0; j < s->getNumSubjects(); j++) {
+                marks[j][r] = static_cast<unsigned char>(s->getMarks(j));
+            }
+        }
+    }
+};
+
+enum class CompareOp { Eq, Ne, Lt, Le, Gt, Ge };
+
+struct QueryCondition {
+    enum Column { Course, Grade, Average, Mark, AnyMark } column;
+    CompareOp op;
+    int subject;     // for Mark, 0-based
+    double value;    // course id / grade code / number
+};
+
+struct QueryAggregate {
+    enum Kind { Count, Avg, Min, Max, Percentile, PassRate } kind;
+    bool onMark;     // false: student average, true: one subject's mark
+    int subject;
+    double param;    // percentile (0-100) or pass mark
+    string label;
+};
+
+struct Query {
+    vector<QueryCondition> conditions;
+    enum GroupBy { None, ByCourse, ByGrade } groupBy = None;
+    vector<QueryAggregate> aggregates;
+};
+
+struct QueryResult {
+    vector<string> header;
+    vector<vector<string>> rows;
+    size_t matched = 0;
+};
+
+class QueryEngine {
+public:
+    static constexpr size_t BATCH_SIZE = 1024;
+    
+private:
+    const StudentColumns& cols;
+    
+    // Per-group running state for every aggregate
+    struct GroupState {
+        size_t rows = 0;
+        vector<size_t> count;
+        vector<double> sum, min, max;
+        vector<vector<double>> values;  // percentiles of averages
+        vector<std::array<size_t, 101>> histogram;  // percentiles of marks
+    };
+    
+    // The core filter kernel: keeps the rows of `in` whose value passes `test`.
+    // The write is unconditional and only the output position depends on the
+    // test, so the loop has no hard-to-predict branch.
+    template <typename T, typename Test>
+    static size_t selectLoop(const T* column, const unsigned* in, size_t n, unsigned* out, Test test) {
+        size_t k = 0;
+        for (size_t i = 0; i < n; i++) {
+            unsigned r = in[i];
+            out[k] = r;
+            k += test(column[r]) ? 1 : 0;
+        }
+        return k;
+    }
+    
+    template <typename T>
+    static bool compare(T v, CompareOp op, double value) {
+        switch (op) {
+            case CompareOp::Eq: return v == value;
+            case CompareOp::Ne: return v != value;
+            case CompareOp::Lt: return v < value;
+            case CompareOp::Le: return v <= value;
+            case CompareOp::Gt: return v > value;
+            case CompareOp::Ge: return v >= value;
+        }
+        return false;
+    }
+    
+    // Dispatch on the operator once per batch, not once per row
+    template <typename T>
+    static size_t selectWhere(const T* column, CompareOp op, double value, bool skipMissing,
+                              const unsigned* in, size_t n, unsigned* out) {
+        const T missing = static_cast<T>(StudentColumns::NO_MARK);
+        switch (op) {
+            case CompareOp::Eq: return selectLoop(column, in, n, out, [=](T v) { return v == value && !(skipMissing && v == missing); });
+            case CompareOp::Ne: return selectLoop(column, in, n, out, [=](T v) { return v != value && !(skipMissing && v == missing); });
+            case CompareOp::Lt: return selectLoop(column, in, n, out, [=](T v) { return v < value && !(skipMissing && v == missing); });
+            case CompareOp::Le: return selectLoop(column, in, n, out, [=](T v) { return v <= value && !(skipMissing && v == missing); });
+            case CompareOp::Gt: return selectLoop(column, in, n, out, [=](T v) { return v > value && !(skipMissing && v == missing); });
+            case CompareOp::Ge: return selectLoop(column, in, n, out, [=](T v) { return v >= value && !(skipMissing && v == missing); });
+        }
+        return 0;
+    }
+    
+    size_t applyCondition(const QueryCondition& c, const unsigned* in, size_t n, unsigned* out) const {
+        switch (c.column) {
+            case QueryCondition::Course:
+                return selectWhere(cols.courseId.data(), c.op, c.value, false, in, n, out);
+            case QueryCondition::Grade:
+                return selectWhere(cols.grade.data(), c.op, c.value, false, in, n, out);
+            case QueryCondition::Average:
+                return selectWhere(cols.average.data(), c.op, c.value, false, in, n, out);
+            case QueryCondition::Mark:
+                if (c.subject >= static_cast<int>(cols.marks.size())) return 0;
+                return selectWhere(cols.marks[c.subject].data(), c.op, c.value, true, in, n, out);
+            case QueryCondition::AnyMark: {
+                // OR across subject columns into a per-batch match flag, then compact
+                unsigned char hit[BATCH_SIZE] = {};
+                for (auto& column : cols.marks) {
+                    for (size_t i = 0; i < n; i++) {
+                        unsigned char v = column[in[i]];
+                        hit[i] |= (v != StudentColumns::NO_MARK && compare(v, c.op, c.value)) ? 1 : 0;
+                    }
+                }
+                size_t k = 0;
+                for (size_t i = 0; i < n; i++) {
+                    out[k] = in[i];
+                    k += hit[i];
+                }
+                return k;
+            }
+        }
+        return 0;
+    }
+    
+    void accumulate(const Query& q, GroupState& g, unsigned r) const {
+        g.rows++;
+        for (size_t a = 0; a < q.aggregates.size(); a++) {
+            const QueryAggregate& agg = q.aggregates[a];
+            double v;
+            if (agg.onMark) {
+                if (agg.subject >= static_cast<int>(cols.marks.size())) continue;
+                unsigned char m = cols.marks[agg.subject][r];
+                if (m == StudentColumns::NO_MARK) continue;
+                v = m;
+            } else {
+                v = cols.average[r];
+            }
+            if (agg.kind == QueryAggregate::PassRate) v = v >= agg.param ? 1.0 : 0.0;
+            if (g.count[a] == 0) {
+                g.min[a] = g.max[a] = v;
+            } else {
+                g.min[a] = std::min(g.min[a], v);
+                g.max[a] = std::max(g.max[a], v);
+            }
+            g.count[a]++;
+            g.sum[a] += v;
+            if (agg.kind == QueryAggregate::Percentile) {
+                // Marks are whole numbers 0-100, so a histogram replaces the value list
+                if (agg.onMark) g.histogram[a][static_cast<size_t>(v)]++;
+                else g.values[a].push_back(v);
+            }
+        }
+    }
+    
+    static string formatNumber(double v) {
+        std::ostringstream os;
+        os << fixed << setprecision(2) << v;
+        return os.str();
+    }
+    
+    string aggregateValue(const QueryAggregate& agg, GroupState& g, size_t a) const {
+        if (agg.kind == QueryAggregate::Count) return std::to_string(g.rows);
+        if (g.count[a] == 0) return "-";
+        switch (agg.kind) {
+            case QueryAggregate::Avg: return formatNumber(g.sum[a] / g.count[a]);
+            case QueryAggregate::Min: return formatNumber(g.min[a]);
+            case QueryAggregate::Max: return formatNumber(g.max[a]);
+            case QueryAggregate::PassRate: return formatNumber(100.0 * g.sum[a] / g.count[a]) + "%";
+            case QueryAggregate::Percentile: {
+                size_t k = static_cast<size_t>(agg.param / 100.0 * (g.count[a] - 1) + 0.5);
+                if (agg.onMark) {
+                    size_t seen = 0;
+                    for (int mark = 0; mark <= 100; mark++) {
+                        seen += g.histogram[a][mark];
+                        if (seen > k) return formatNumber(mark);
+                    }
+                    return "-";
+                }
+                vector<double>& v = g.values[a];
+                std::nth_element(v.begin(), v.begin() + k, v.end());
+                return formatNumber(v[k]);
+            }
+            default: return "-";
+        }
+    }
+    
+public:
+    explicit QueryEngine(const StudentColumns& columns) : cols(columns) {}
+    
+    QueryResult run(const Query& q, size_t listLimit = 50) const {
+        QueryResult result;
+        size_t numGroups = q.groupBy == Query::ByCourse ? cols.courseNames.size()
+                         : q.groupBy == Query::ByGrade ? static_cast<size_t>(AbsoluteGrading::numGrades) : 1;
+        vector<GroupState> groups(numGroups);
+        for (auto& g : groups) {
+            g.count.assign(q.aggregates.size(), 0);
+            g.sum.assign(q.aggregates.size(), 0.0);
+            g.min.assign(q.aggregates.size(), 0.0);
+            g.max.assign(q.aggregates.size(), 0.0);
+            g.values.assign(q.aggregates.size(), vector<double>());
+            g.histogram.assign(q.aggregates.size(), std::array<size_t, 101>{});
+        }
+        bool listing = q.aggregates.empty();
+        
+        unsigned selA[BATCH_SIZE], selB[BATCH_SIZE];
+        for (size_t start = 0; start < cols.size(); start += BATCH_SIZE) {
+            size_t n = std::min(BATCH_SIZE, cols.size() - start);
+            for (size_t i = 0; i < n; i++) selA[i] = static_cast<unsigned>(start + i);
+            unsigned* sel = selA;
+            unsigned* next = selB;
+            for (auto& c : q.conditions) {
+                n = applyCondition(c, sel, n, next);
+                std::swap(sel, next);
+                if (n == 0) break;
+            }
+            result.matched += n;
+            
+            if (listing) {
+                for (size_t i = 0; i < n && result.rows.size() < listLimit; i++) {
+                    unsigned r = sel[i];
+                    result.rows.push_back({std::to_string(cols.rollNo[r]), string(cols.source[r]->getName()),
+                                           cols.courseNames[cols.courseId[r]], formatNumber(cols.average[r])});
+                }
+                continue;
+            }
+            for (size_t i = 0; i < n; i++) {
+                unsigned r = sel[i];
+                size_t key = q.groupBy == Query::ByCourse ? cols.courseId[r]
+                           : q.groupBy == Query::ByGrade ? cols.grade[r] : 0;
+                accumulate(q, groups[key], r);
+            }
+        }
+        
+        if (listing) {
+            result.header = {"Roll No", "Name", "Course", "Average"};
+            return result;
+        }
+        if (q.groupBy == Query::ByCourse) result.header.push_back("Course");
+        if (q.groupBy == Query::ByGrade) result.header.push_back("Grade");
+        for (auto& agg : q.aggregates) result.header.push_back(agg.label);
+        for (size_t key = 0; key < numGroups; key++) {
+            if (q.groupBy != Query::None && groups[key].rows == 0) continue;
+            vector<string> row;
+            if (q.groupBy == Query::ByCourse) row.push_back(cols.courseNames[key]);
+            if (q.groupBy == Query::ByGrade) row.push_back(AbsoluteGrading::labels[key]);
+            for (size_t a = 0; a < q.aggregates.size(); a++) {
+                row.push_back(aggregateValue(q.aggregates[a], groups[key], a));
+            }
+            result.rows.push_back(row);
+        }
+        return result;
+    }
+    
+    // Parses the query syntax described above; throws runtime_error on mistakes
+    static Query parse(const string& text, const StudentColumns& cols) {
+        Query q;
+        std::istringstream in(text);
+        string word;
+        bool inWhere = false;
+        while (in >> word) {
+            if (word == "where" || word == "and") {
+                inWhere = true;
+            } else if (word == "by") {
+                inWhere = false;
+                if (!(in >> word) || (word != "course" && word != "grade")) {
+                    throw runtime_error("'by' must be followed by course or grade");
+                }
+                q.groupBy = word == "course" ? Query::ByCourse : Query::ByGrade;
+            } else if (inWhere) {
+                q.conditions.push_back(parseCondition(word, cols));
+                inWhere = false;
+            } else {
+                q.aggregates.push_back(parseAggregate(word));
+            }
+        }
+        return q;
+    }
+    
+private:
+    static int parseMarkColumn(const string& name) {
+        if (name.compare(0, 4, "mark") != 0 || name.size() == 4) {
+            throw runtime_error("Unknown column: " + name);
+        }
+        int subject = std::stoi(name.substr(4));
+        if (subject < 1) throw runtime_error("Marks are numbered from 1: " + name);
+        return subject - 1;
+    }
+    
+    static QueryCondition parseCondition(const string& word, const StudentColumns& cols) {
+        static const char* const ops[] = {"!=", "<=", ">=", "=", "<", ">"};
+        static const CompareOp codes[] = {CompareOp::Ne, CompareOp::Le, CompareOp::Ge,
+                                          CompareOp::Eq, CompareOp::Lt, CompareOp::Gt};
+        for (int i = 0; i < 6; i++) {
+            size_t pos = word.find(ops[i]);
+            if (pos == string::npos || pos == 0) continue;
+            string column = word.substr(0, pos);
+            string value = word.substr(pos + string(ops[i]).size());
+            QueryCondition c;
+            c.op = codes[i];
+            c.subject = 0;
+            bool equality = c.op == CompareOp::Eq || c.op == CompareOp::Ne;
+            if (column == "course") {
+                if (!equality) throw runtime_error("course only supports = and !=");
+                c.column = QueryCondition::Course;
+                auto it = std::find(cols.courseNames.begin(), cols.courseNames.end(), value);
+                // An unknown course matches nothing (or everything for !=)
+                c.value = it == cols.courseNames.end() ? -1.0 : static_cast<double>(it - cols.courseNames.begin());
+            } else if (column == "grade") {
+                if (!equality) throw runtime_error("grade only supports = and !=");
+                c.column = QueryCondition::Grade;
+                c.value = -1.0;
+                for (int g = 0; g < AbsoluteGrading::numGrades; g++) {
+                    if (value == AbsoluteGrading::labels[g]) c.value = g;
+                }
+            } else {
+                if (column == "avg") {
+                    c.column = QueryCondition::Average;
+                } else if (column == "anymark") {
+                    c.column = QueryCondition::AnyMark;
+                } else {
+                    c.column = QueryCondition::Mark;
+                    c.subject = parseMarkColumn(column);
+                }
+                c.value = std::stod(value);
+            }
+            return c;
+        }
+        throw runtime_error("Cannot read condition: " + word);
+    }
+    
+    static QueryAggregate parseAggregate(const string& word) {
+        QueryAggregate agg;
+        agg.label = word;
+        agg.onMark = false;
+        agg.subject = 0;
+        agg.param = 0.0;
+        if (word == "count") {
+            agg.kind = QueryAggregate::Count;
+            return agg;
+        }
+        size_t open = word.find('(');
+        if (open == string::npos || word.back() != ')') {
+            throw runtime_error("Cannot read aggregate: " + word);
+        }
+        string fn = word.substr(0, open);
+        string arg = word.substr(open + 1, word.size() - open - 2);
+        size_t comma = arg.find(',');
+        string target = arg.substr(0, comma);
+        
+        if (fn == "avg") agg.kind = QueryAggregate::Avg;
+        else if (fn == "min") agg.kind = QueryAggregate::Min;
+        else if (fn == "max") agg.kind = QueryAggregate::Max;
+        else if (fn == "passrate") {
+            agg.kind = QueryAggregate::PassRate;
+            agg.param = comma == string::npos ? 50.0 : std::stod(arg.substr(comma + 1));
+        } else if (fn.size() > 1 && fn[0] == 'p') {
+            agg.kind = QueryAggregate::Percentile;
+            agg.param = std::stod(fn.substr(1));
+            if (agg.param < 0 || agg.param > 100) throw runtime_error("Percentile must be 0-100");
+        } else {
+            throw runtime_error("Unknown aggregate: " + fn);
+        }
+        
+        if (target != "avg") {
+            agg.onMark = true;
+            agg.subject = parseMarkColumn(target);
+        }
+        return agg;
+    }
+};
+
+inline void printQueryResult(const QueryResult& result) {
+    for (auto& column : result.header) cout << left << setw(18) << column;
+    cout << '\n' << string(18 * result.header.size(), '-') << '\n';
+    for (auto& row : result.rows) {
+        for (auto& value : row) cout << left << setw(18) << value;
+        cout << '\n';
+    }
+    cout << result.matched << " matching student(s)" << endl;
+}
+
+// Generates students and times some typical queries
+int runQueryBenchmark(size_t numStudents) {
+    const char* courses[] = {"CS", "EE", "ME", "CE", "IT", "Civil", "Chem", "Bio"};
+    vector<Student*> students;
+    unsigned int seed = 7;
+    for (size_t i = 0; i < numStudents; i++) {
+        Student* s = new Student(static_cast<int>(i + 1), "Student " + std::to_string(i + 1), courses[i % 8], 5);
+        for (int j = 0; j < 5; j++) {
+            seed = seed * 1103515245u + 12345u;
+            s->setMarks(j, static_cast<int>(20 + (seed >> 16) % 81));
+        }
+        students.push_back(s);
+    }
+    
+    typedef std::chrono::steady_clock Clock;
+    auto start = Clock::now();
+    StudentColumns columns;
+    columns.build(students);
+    cout << "Built columns for " << numStudents << " students in " << fixed << setprecision(1)
+         << std::chrono::duration<double, std::milli>(Clock::now() - start).count() << " ms" << endl;
+    
+    QueryEngine engine(columns);
+    const char* queries[] = {
+        "by course passrate(mark3,50)",
+        "where anymark<35 count",
+        "where course=CS and avg>=60 by grade count avg(avg) min(mark1) max(mark1)",
+        "by course p90(avg) p50(mark2)",
+    };
+    for (const char* text : queries) {
+        start = Clock::now();
+        QueryResult result = engine.run(QueryEngine::parse(text, columns));
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        cout << "\n> " << text << "   (" << fixed << setprecision(1) << ms << " ms)" << endl;
+        printQueryResult(result);
+    }
+    for (auto s : students) delete s;
+    return 0;
+}
+
+// ==================== MEMORY REPORT ====================
+// Field layout of Student before course/name interning, for comparison
+struct LegacyStudentLayout {
+    int rollNo;
+    string name;
+    string course;
+    int* marks;
+    int numSubjects;
+};
+
+// Bytes per student with separate std::string members (before) and with the
+// string pool (after). Allocator bookkeeping is not included in either column.
+inline void printMemoryReport(const vector<Student*>& students) {
+    if (students.empty()) {
+        cout << "\n✗ No students in the system!" << endl;
+        return;
+    }
+    const size_t inlineCapacity = string().capacity();  // short strings need no heap block
+    size_t legacyStrings = 0, marksBytes = 0;
+    for (auto student : students) {
+        size_t nameLen = student->getName().size();
+        size_t courseLen = student->getCourse().size();
+        if (nameLen > inlineCapacity) legacyStrings += nameLen + 1;
+        if (courseLen > inlineCapacity) legacyStrings += courseLen + 1;
+        marksBytes += sizeof(int) * static_cast<size_t>(student->getNumSubjects());
+    }
+    double n = static_cast<double>(students.size());
+    double pointer = sizeof(Student*);
+    double marks = marksBytes / n;
+    double before = sizeof(LegacyStudentLayout) + legacyStrings / n + marks + pointer;
+    double poolShare = StringPool::global().bytesReserved() / n;
+    double after = sizeof(Student) + poolShare + marks + pointer;
+    
+    cout << "\n╔════════════════════════════════════════════════════════════╗" << endl;
+    cout << "║                  MEMORY PER STUDENT (BYTES)                ║" << endl;
+    cout << "╚════════════════════════════════════════════════════════════╝" << endl;
+    cout << left << setw(30) << "" << setw(15) << "Before" << "After" << endl;
+    cout << string(60, '-') << endl;
+    cout << fixed << setprecision(1);
+    cout << left << setw(30) << "Student object" << setw(15) << static_cast<double>(sizeof(LegacyStudentLayout))
+         << static_cast<double>(sizeof(Student)) << endl;
+    cout << left << setw(30) << "Name/course heap strings" << setw(15) << legacyStrings / n << 0.0 << endl;
+    cout << left << setw(30) << "String pool (shared)" << setw(15) << 0.0 << poolShare << endl;
+    cout << left << setw(30) << "Marks array" << setw(15) << marks << marks << endl;
+    cout << left << setw(30) << "Pointer in student list" << setw(15) << pointer << pointer << endl;
+    cout << string(60, '-') << endl;
+    cout << left << setw(30) << "Total" << setw(15) << before << after << endl;
+    cout << "Students: " << students.size() << ", courses interned: "
+         << StringPool::global().numCourses() - 1 << ", name bytes: "
+         << StringPool::global().nameBytes() << endl;
+}
+
+// Generates students with realistic name lengths and ~50 courses
+int runMemoryBenchmark(size_t numStudents) {
+    vector<Student*> students;
+    students.reserve(numStudents);
+    for (size_t i = 0; i < numStudents; i++) {
+        string name = "Student Firstname Lastname " + std::to_string(i + 1);
+        string course = "B.Tech Programme " + std::to_string(i % 50 + 1);
+        students.push_back(new Student(static_cast<int>(i + 1), name, course, 5));
+    }
+    printMemoryReport(students);
+    for (auto s : students) delete s;
+    return 0;
+}
+
+// ==================== PAGED STUDENT ARCHIVE (BUFFER POOL) ====================
+// Disk-backed store for archives larger than memory. Students are kept as
+// fixed-size records in 4 KB pages of one file; only as many pages as the
+// memory budget allows are held in a buffer pool, and the rest are read in
+// on demand. Pages are pinned while in use and replaced with the CLOCK
+// algorithm (a cheap approximation of least-recently-used).
+#if SMS_HAVE_POSIX
+struct ArchiveRecord {
+    static constexpr int MAX_NAME = 56;
+    static constexpr int MAX_COURSE = 32;
+    static constexpr int MAX_SUBJECTS = 32;
+    
+    int rollNo;
+    unsigned char numSubjects;
+    unsigned char nameLen;
+    unsigned char courseLen;
+    unsigned char reserved;
+    char name[MAX_NAME];      // longer names are truncated
+    char course[MAX_COURSE];
+    unsigned char marks[MAX_SUBJECTS];
+    
+    void fromStudent(const Student& s) {
+        if (s.getNumSubjects() > MAX_SUBJECTS) {
+            throw runtime_error("Archive records hold at most 32 subjects");
+        }
+        rollNo = s.getRollNo();
+        numSubjects = static_cast<unsigned char>(s.getNumSubjects());
+        nameLen = static_cast<unsigned char>(std::min<size_t>(s.getName().size(), MAX_NAME));
+        courseLen = static_cast<unsigned char>(std::min<size_t>(s.getCourse().size(), MAX_COURSE));
+        reserved = 0;
+        std::memset(name, 0, sizeof(name));
+        std::memset(course, 0, sizeof(course));
+        std::memset(marks, 0, sizeof(marks));
+        std::memcpy(name, s.getName().data(), nameLen);
+        std::memcpy(course, s.getCourse().data(), courseLen);
+        for (int i = 0; i < numSubjects; i++) {
+            marks[i] = static_cast<unsigned char>(s.getMarks(i));
+        }
+    }
+    
+    // The copy owns its name, so lookups do not grow the string pool
+    Student toStudent() const {
+        Student s(rollNo, std::string_view(name, nameLen), std::string_view(course, courseLen), numSubjects,
+                  OwnedName());
+        for (int i = 0; i < numSubjects; i++) {
+            s.setMarks(i, marks[i]);
+        }
+        return s;
+    }
+    
+    double average() const {
+        if (numSubjects == 0) return 0.0;
+        int total = 0;
+        for (int i = 0; i < numSubjects; i++) total += marks[i];
+        return static_cast<double>(total) / numSubjects;
+    }
+};
+static_assert(sizeof(ArchiveRecord) == 128, "ArchiveRecord must stay 128 bytes");
+
+class PagedStudentStore {
+public:
+    static constexpr size_t PAGE_SIZE = 4096;
+    static constexpr size_t RECORDS_PER_PAGE = PAGE_SIZE / sizeof(ArchiveRecord);
+    static constexpr size_t PREFETCH_PAGES = 32;
+    
+    struct PoolStats {
+        unsigned long long hits = 0;
+        unsigned long long misses = 0;
+        unsigned long long evictions = 0;
+        unsigned long long writes = 0;
+    };
+    
+private:
+    // Page 0 holds this header; records start on page 1
+    struct FileHeader {
+        char magic[8];
+        unsigned long long recordCount;
+    };
+    
+    struct Frame {
+        size_t page;
+        int pinCount;
+        bool dirty;
+        bool referenced;
+        bool used;
+    };
+    
+    int fd;
+    string path;
+    unsigned long long recordCount;
+    vector<char> frameData;                         // frames * PAGE_SIZE bytes
+    vector<Frame> frames;
+    std::unordered_map<size_t, size_t> pageTable;   // page number -> frame
+    size_t clockHand;
+    PoolStats stats;
+    
+    // Roll number -> record number, open addressing (8 bytes per slot).
+    // EMPTY_KEY marks a free slot, so that roll number cannot be archived.
+    static constexpr int EMPTY_KEY = std::numeric_limits<int>::min();
+    vector<std::pair<int, unsigned>> index;
+    size_t indexUsed;
+    
+    char* frameBytes(size_t frame) { return &frameData[frame * PAGE_SIZE]; }
+    
+    void writePage(size_t frame) {
+        off_t offset = static_cast<off_t>(frames[frame].page * PAGE_SIZE);
+        if (::pwrite(fd, frameBytes(frame), PAGE_SIZE, offset) != static_cast<ssize_t>(PAGE_SIZE)) {
+            throw runtime_error("Cannot write archive page");
+        }
+        frames[frame].dirty = false;
+        stats.writes++;
+    }
+    
+    // CLOCK: sweep the frames, giving referenced pages a second chance
+    size_t findVictim() {
+        for (size_t sweep = 0; sweep < frames.size() * 2; sweep++) {
+            size_t f = clockHand;
+            clockHand = (clockHand + 1) % frames.size();
+            if (!frames[f].used) return f;
+            if (frames[f].pinCount > 0) continue;
+            if (frames[f].referenced) {
+                frames[f].referenced = false;
+                continue;
+            }
+            return f;
+        }
+        throw runtime_error("All archive pages are pinned; raise the memory budget");
+    }
+    
+    size_t pin(size_t page) {
+        auto it = pageTable.find(page);
+        if (it != pageTable.end()) {
+            stats.hits++;
+            Frame& frame = frames[it->second];
+            frame.pinCount++;
+            frame.referenced = true;
+            return it->second;
+        }
+        
+        stats.misses++;
+        size_t f = findVictim();
+        if (frames[f].used) {
+            if (frames[f].dirty) writePage(f);
+            pageTable.erase(frames[f].page);
+            stats.evictions++;
+        }
+        ssize_t n = ::pread(fd, frameBytes(f), PAGE_SIZE, static_cast<off_t>(page * PAGE_SIZE));
+        if (n < 0) throw runtime_error("Cannot read archive page");
+        // A page beyond the end of the file starts out empty
+        std::memset(frameBytes(f) + n, 0, PAGE_SIZE - static_cast<size_t>(n));
+        frames[f] = {page, 1, false, true, true};
+        pageTable[page] = f;
+        return f;
+    }
+    
+    void unpin(size_t frame, bool dirty) {
+        frames[frame].pinCount--;
+        if (dirty) frames[frame].dirty = true;
+    }
+    
+    // Keeps a page pinned for as long as it is in scope
+    class PageGuard {
+    private:
+        PagedStudentStore& store;
+        size_t frame;
+        bool dirty;
+        
+    public:
+        PageGuard(PagedStudentStore& s, size_t page) : store(s), frame(s.pin(page)), dirty(false) {}
+        ~PageGuard() { store.unpin(frame, dirty); }
+        PageGuard(const PageGuard&) = delete;
+        PageGuard& operator=(const PageGuard&) = delete;
+        
+        ArchiveRecord* record(size_t slot) {
+            return reinterpret_cast<ArchiveRecord*>(store.frameBytes(frame)) + slot;
+        }
+        void markDirty() { dirty = true; }
+    };
+    
+    static size_t pageOf(unsigned long long record) { return 1 + static_cast<size_t>(record / RECORDS_PER_PAGE); }
+    static size_t slotOf(unsigned long long record) { return static_cast<size_t>(record % RECORDS_PER_PAGE); }
+    
+    size_t indexSlot(int roll) const {
+        unsigned int h = static_cast<unsigned int>(roll) * 2654435761u;
+        return h & (index.size() - 1);
+    }
+    
+    void indexInsert(int roll, unsigned record) {
+        if ((indexUsed + 1) * 2 > index.size()) {
+            vector<std::pair<int, unsigned>> old;
+            old.swap(index);
+            index.assign(std::max<size_t>(1024, old.size() * 2), {EMPTY_KEY, 0});
+            indexUsed = 0;
+            for (auto& entry : old) {
+                if (entry.first != EMPTY_KEY) indexInsert(entry.first, entry.second);
+            }
+        }
+        size_t i = indexSlot(roll);
+        while (index[i].first != EMPTY_KEY && index[i].first != roll) {
+            i = (i + 1) & (index.size() - 1);
+        }
+        if (index[i].first == EMPTY_KEY) indexUsed++;
+        index[i] = {roll, record};
+    }
+    
+    bool indexFind(int roll, unsigned& record) const {
+        if (index.empty() || roll == EMPTY_KEY) return false;
+        size_t i = indexSlot(roll);
+        while (index[i].first != EMPTY_KEY) {
+            if (index[i].first == roll) {
+                record = index[i].second;
+                return true;
+            }
+            i = (i + 1) & (index.size() - 1);
+        }
+        return false;
+    }
+    
+    // Ask the kernel to start reading the next pages while we work on this one
+    void prefetch(size_t fromPage) {
+#ifdef POSIX_FADV_WILLNEED
+        ::posix_fadvise(fd, static_cast<off_t>(fromPage * PAGE_SIZE),
+                        static_cast<off_t>(PREFETCH_PAGES * PAGE_SIZE), POSIX_FADV_WILLNEED);
+#else
+        (void)fromPage;
+#endif
+    }
+    
+public:
+    // Opens (or creates) an archive file; budgetBytes caps the buffer pool
+    PagedStudentStore(const string& file, size_t budgetBytes)
+        : fd(-1), path(file), recordCount(0), clockHand(0), indexUsed(0) {
+        size_t numFrames = std::max<size_t>(budgetBytes / PAGE_SIZE, 8);
+        frameData.assign(numFrames * PAGE_SIZE, 0);
+        frames.assign(numFrames, Frame{0, 0, false, false, false});
+        
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) throw runtime_error("Cannot open archive " + path);
+        FileHeader header;
+        ssize_t n = ::pread(fd, &header, sizeof(header), 0);
+        if (n == static_cast<ssize_t>(sizeof(header))) {
+            if (std::memcmp(header.magic, "SMSARCH1", 8) != 0) {
+                ::close(fd);
+                throw runtime_error(path + " is not a student archive");
+            }
+            recordCount = header.recordCount;
+        } else if (n != 0) {
+            ::close(fd);
+            throw runtime_error(path + " is not a student archive");
+        }
+        
+        // Rebuild the roll-number index with one sequential pass
+        scan([this](const ArchiveRecord& r, unsigned long long id) {
+            if (r.rollNo != EMPTY_KEY) indexInsert(r.rollNo, static_cast<unsigned>(id));
+        });
+    }
+    
+    ~PagedStudentStore() {
+        try {
+            flush();
+        } catch (const exception& e) {
+            std::cerr << "Archive: " << e.what() << endl;
+        }
+        ::close(fd);
+    }
+    
+    PagedStudentStore(const PagedStudentStore&) = delete;
+    PagedStudentStore& operator=(const PagedStudentStore&) = delete;
+    
+    // Write back dirty pages and the header
+    void flush() {
+        for (size_t f = 0; f < frames.size(); f++) {
+            if (frames[f].used && frames[f].dirty) writePage(f);
+        }
+        vector<char> page(PAGE_SIZE, 0);
+        FileHeader header;
+        std::memcpy(header.magic, "SMSARCH1", 8);
+        header.recordCount = recordCount;
+        std::memcpy(page.data(), &header, sizeof(header));
+        if (::pwrite(fd, page.data(), PAGE_SIZE, 0) != static_cast<ssize_t>(PAGE_SIZE)) {
+            throw runtime_error("Cannot write archive header");
+        }
+    }
+    
+    // Adds a student, or replaces the record with the same roll number
+    void putStudent(const Student& s) {
+        if (s.getRollNo() == EMPTY_KEY) {
+            throw runtime_error("Roll number " + std::to_string(EMPTY_KEY) + " cannot be archived");
+        }
+        // Convert first: a student that does not fit must not take up a record
+        ArchiveRecord record;
+        record.fromStudent(s);
+        unsigned id;
+        bool exists = indexFind(s.getRollNo(), id);
+        if (!exists) {
+            if (recordCount >= std::numeric_limits<unsigned>::max()) {
+                throw runtime_error("Archive is full");
+            }
+            id = static_cast<unsigned>(recordCount);
+        }
+        PageGuard guard(*this, pageOf(id));
+        *guard.record(slotOf(id)) = record;
+        guard.markDirty();
+        if (!exists) {
+            recordCount++;
+            indexInsert(s.getRollNo(), id);
+        }
+    }
+    
+    // Copies the raw record; no Student (or pooled name) is created
+    bool findRecord(int roll, ArchiveRecord& result) {
+        unsigned id;
+        if (!indexFind(roll, id)) return false;
+        PageGuard guard(*this, pageOf(id));
+        result = *guard.record(slotOf(id));
+        return true;
+    }
+    
+    bool findStudent(int roll, Student& result) {
+        ArchiveRecord record;
+        if (!findRecord(roll, record)) return false;
+        result = record.toStudent();
+        return true;
+    }
+    
+    bool updateMarks(int roll, int subject, int mark) {
+        unsigned id;
+        if (!indexFind(roll, id)) return false;
+        PageGuard guard(*this, pageOf(id));
+        ArchiveRecord* record = guard.record(slotOf(id));
+        if (subject < 0 || subject >= record->numSubjects) {
+            throw InvalidMarksException("Invalid subject index");
+        }
+        if (mark < 0 || mark > 100) {
+            throw InvalidMarksException("Marks must be between 0 and 100");
+        }
+        record->marks[subject] = static_cast<unsigned char>(mark);
+        guard.markDirty();
+        return true;
+    }
+    
+    // Visits every record in file order, prefetching pages ahead of the scan
+    template <typename Visit>
+    void scan(Visit visit) {
+        size_t lastPage = recordCount == 0 ? 0 : pageOf(recordCount - 1);
+        for (size_t page = 1; page <= lastPage; page++) {
+            if ((page - 1) % PREFETCH_PAGES == 0) prefetch(page + PREFETCH_PAGES);
+            PageGuard guard(*this, page);
+            unsigned long long first = (page - 1) * RECORDS_PER_PAGE;
+            size_t count = static_cast<size_t>(std::min<unsigned long long>(RECORDS_PER_PAGE, recordCount - first));
+            for (size_t slot = 0; slot < count; slot++) {
+                visit(static_cast<const ArchiveRecord&>(*guard.record(slot)), first + slot);
+            }
+        }
+    }
+    
+    unsigned long long size() const { return recordCount; }
+    size_t getNumFrames() const { return frames.size(); }
+    const PoolStats& getStats() const { return stats; }
+    const string& getPath() const { return path; }
+    size_t indexBytes() const { return index.size() * sizeof(index[0]); }
+};
+
+inline void printArchiveStats(PagedStudentStore& archive) {
+    typedef std::chrono::steady_clock Clock;
+    auto start = Clock::now();
+    CohortStats stats;
+    archive.scan([&stats](const ArchiveRecord& r, unsigned long long) {
+        CohortStats one;
+        one.count = 1;
+        one.sumAverage = one.minAverage = one.maxAverage = r.average();
+        stats.merge(one);
+    });
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    const PagedStudentStore::PoolStats& pool = archive.getStats();
+    cout << "Archive " << archive.getPath() << ": " << archive.size() << " students" << endl;
+    cout << "Scan: mean average " << fixed << setprecision(2) << stats.mean() << ", min "
+         << stats.minAverage << ", max " << stats.maxAverage << " in " << setprecision(1) << ms << " ms" << endl;
+    cout << "Buffer pool: " << archive.getNumFrames() << " pages ("
+         << archive.getNumFrames() * PagedStudentStore::PAGE_SIZE / 1024 << " KB), "
+         << pool.hits << " hits, " << pool.misses << " misses, " << pool.evictions
+         << " evictions, " << pool.writes << " page writes" << endl;
+    cout << "Roll-number index: " << archive.indexBytes() / 1024 << " KB" << endl;
+}
+
+// Builds an archive of generated students in a temporary file, then times
+// random lookups, mark updates and a full scan under a small memory budget
+int runArchiveBenchmark(size_t numRecords, size_t budgetMB) {
+    typedef std::chrono::steady_clock Clock;
+    auto millis = [](Clock::time_point since) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+    };
+    string file = "/tmp/sms_archive_" + std::to_string(::getpid()) + ".dat";
+    int status = 0;
+    try {
+        PagedStudentStore archive(file, budgetMB * 1024 * 1024);
+        auto start = Clock::now();
+        unsigned int seed = 99;
+        for (size_t i = 0; i < numRecords; i++) {
+            Student s(static_cast<int>(i + 1), "Archived Student " + std::to_string(i + 1), "CS", 5);
+            for (int j = 0; j < 5; j++) {
+                seed = seed * 1103515245u + 12345u;
+                s.setMarks(j, static_cast<int>((seed >> 16) % 101));
+            }
+            archive.putStudent(s);
+        }
+        archive.flush();
+        cout << "Wrote " << numRecords << " records (" << numRecords * sizeof(ArchiveRecord) / (1024 * 1024)
+             << " MB) with a " << budgetMB << " MB buffer pool in " << fixed << setprecision(1)
+             << millis(start) << " ms" << endl;
+        
+        start = Clock::now();
+        size_t found = 0;
+        ArchiveRecord record;
+        for (int i = 0; i < 100000; i++) {
+            seed = seed * 1103515245u + 12345u;
+            int roll = static_cast<int>(seed % numRecords) + 1;
+            if (archive.findRecord(roll, record)) found++;
+            archive.updateMarks(roll, 0, 75);
+        }
+        cout << "100000 random lookups + mark updates: " << millis(start) << " ms (" << found << " found)" << endl;
+        printArchiveStats(archive);
+    } catch (const exception& e) {
+        cout << "✗ Error: " << e.what() << endl;
+        status = 1;
+    }
+    ::unlink(file.c_str());
+    return status;
+}
+#endif
+
+// ==================== STUDENT SNAPSHOT (PRECOMPUTED DERIVED DATA) ====================
+// A snapshot file holds the students (base data) together with the data that
+// is derived from them: mark totals, absolute grade codes, the rank order by
+// average and the roll-number index. Each derived section carries a stamp made
+// from a hash of the base sections and the section's format version. At
+// startup the file is mapped, sections whose stamp still matches are copied
+// as they are, and only the stale ones are rebuilt from the students.
+
+struct RollIndexEntry {
+    int rollNo;
+    unsigned position;  // index into the student list
+};
+
+// Derived data kept next to the student list. Cheap changes (a new student,
+// new marks) update it in place; anything else marks a part stale and that
+// part is rebuilt the next time it is needed.
+struct DerivedStudentData {
+    vector<unsigned> totals;            // sum of marks per student
+    vector<unsigned char> gradeCodes;   // AbsoluteGrading code per student
+    vector<unsigned> rankOrder;         // best average first, ties in list order
+    vector<RollIndexEntry> rollIndex;   // sorted by roll number
+    bool scoresStale = true;            // totals and grade codes
+    bool rankStale = true;
+    bool indexStale = true;
+    
+    static unsigned totalOf(const Student& s) {
+        unsigned total = 0;
+        for (int j = 0; j < s.getNumSubjects(); j++) total += static_cast<unsigned>(s.getMarks(j));
+        return total;
+    }
+    
+    // Same value as Student::getAverage, computed from the stored total
+    double average(const vector<Student*>& students, size_t position) const {
+        int n = students[position]->getNumSubjects();
+        return n == 0 ? 0.0 : static_cast<double>(totals[position]) / n;
+    }
+    
+    void rebuildScores(const vector<Student*>& students) {
+        totals.resize(students.size());
+        gradeCodes.resize(students.size());
+        for (size_t i = 0; i < students.size(); i++) {
+            totals[i] = totalOf(*students[i]);
+            gradeCodes[i] = GradeTable<AbsoluteGrading>::code(average(students, i));
+        }
+        scoresStale = false;
+    }
+    
+    void rebuildRank(const vector<Student*>& students) {
+        if (scoresStale) rebuildScores(students);
+        vector<double> averages(students.size());
+        for (size_t i = 0; i < students.size(); i++) averages[i] = average(students, i);
+        rankOrder.resize(students.size());
+        for (size_t i = 0; i < rankOrder.size(); i++) rankOrder[i] = static_cast<unsigned>(i);
+        std::stable_sort(rankOrder.begin(), rankOrder.end(), [&averages](unsigned a, unsigned b) {
+            return averages[a] > averages[b];
+        });
+        rankStale = false;
+    }
+    
+    void rebuildIndex(const vector<Student*>& students) {
+        rollIndex.resize(students.size());
+        for (size_t i = 0; i < students.size(); i++) {
+            rollIndex[i] = RollIndexEntry{students[i]->getRollNo(), static_cast<unsigned>(i)};
+        }
+        std::sort(rollIndex.begin(), rollIndex.end(), [](const RollIndexEntry& a, const RollIndexEntry& b) {
+            return a.rollNo < b.rollNo;
+        });
+        indexStale = false;
+    }
+    
+    void refresh(const vector<Student*>& students) {
+        if (scoresStale) rebuildScores(students);
+        if (rankStale) rebuildRank(students);
+        if (indexStale) rebuildIndex(students);
+    }
+    
+    // Position of a roll number in the student list, or -1. A hit is checked
+    // against the list; if the index disagrees it is rebuilt and searched again.
+    long find(const vector<Student*>& students, int roll) {
+        for (int attempt = 0; attempt < 2; attempt++) {
+            if (indexStale) rebuildIndex(students);
+            auto it = std::lower_bound(rollIndex.begin(), rollIndex.end(), roll,
+                [](const RollIndexEntry& e, int r) { return e.rollNo < r; });
+            if (it == rollIndex.end() || it->rollNo != roll) return -1;
+            if (it->position < students.size() && students[it->position]->getRollNo() == roll) {
+                return static_cast<long>(it->position);
+            }
+            indexStale = true;
+        }
+        return -1;
+    }
+    
+    // The last student in the list was just added
+    void studentAdded(const vector<Student*>& students) {
+        size_t position = students.size() - 1;
+        const Student& s = *students[position];
+        if (!scoresStale) {
+            totals.push_back(totalOf(s));
+            gradeCodes.push_back(GradeTable<AbsoluteGrading>::code(average(students, position)));
+        }
+        if (!indexStale) {
+            RollIndexEntry entry{s.getRollNo(), static_cast<unsigned>(position)};
+            auto it = std::upper_bound(rollIndex.begin(), rollIndex.end(), entry,
+                [](const RollIndexEntry& a, const RollIndexEntry& b) { return a.rollNo < b.rollNo; });
+            rollIndex.insert(it, entry);
+        }
+        rankStale = true;
+    }
+    
+    // Marks of a student in the list changed (students outside it are ignored)
+    void marksChanged(const vector<Student*>& students, const Student& s) {
+        long position = find(students, s.getRollNo());
+        if (position < 0 || students[position] != &s) return;
+        if (!scoresStale) {
+            totals[position] = totalOf(s);
+            gradeCodes[position] = GradeTable<AbsoluteGrading>::code(average(students, position));
+        }
+        rankStale = true;
+    }
+    
+    void clear() {
+        totals.clear();
+        gradeCodes.clear();
+        rankOrder.clear();
+        rollIndex.clear();
+        scoresStale = rankStale = indexStale = true;
+    }
+};
+
+// Read-only view of a whole file: mmap where available, otherwise read into memory
+class MappedFile {
+private:
+    const char* data;
+    size_t length;
+#if SMS_HAVE_POSIX
+    void* mapping;
+#else
+    vector<char> buffer;
+#endif
+    
+public:
+    explicit MappedFile(const string& path) : data(nullptr), length(0) {
+#if SMS_HAVE_POSIX
+        mapping = nullptr;
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            int err = errno;
+            ::close(fd);
+            throw runtime_error("Cannot read " + path + ": " + std::strerror(err));
+        }
+        length = static_cast<size_t>(info.st_size);
+        if (length > 0) {
+            mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                int err = errno;
+                ::close(fd);
+                throw runtime_error("Cannot map " + path + ": " + std::strerror(err));
+            }
+            ::madvise(mapping, length, MADV_WILLNEED);
+            data = static_cast<const char*>(mapping);
+        }
+        ::close(fd);  // the mapping stays valid
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw runtime_error("Cannot open " + path);
+        }
+        buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data = buffer.data();
+        length = buffer.size();
+#endif
+    }
+    
+    ~MappedFile() {
+#if SMS_HAVE_POSIX
+        if (mapping != nullptr) ::munmap(mapping, length);
+#endif
+    }
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    const char* bytes() const { return data; }
+    size_t size() const { return length; }
+};
+
+namespace snapshot {
+
+// Sections in file order; the base sections come first
+enum Section : unsigned { Records, Names, Courses, Marks, Totals, Grades, Rank, RollIndex, NUM_SECTIONS };
+constexpr unsigned FIRST_DERIVED = Totals;
+constexpr const char* SECTION_NAMES[NUM_SECTIONS] = {
+    "records", "names", "courses", "marks", "totals", "grade codes", "rank order", "roll index"};
+
+// Bump a section's version when the way it is derived changes; old
+// snapshots then rebuild that section on load instead of trusting it
+constexpr unsigned long long SECTION_VERSION[NUM_SECTIONS] = {1, 1, 1, 1, 1, 1, 1, 1};
+
+constexpr char MAGIC[8] = {'S', 'M', 'S', 'S', 'N', 'A', 'P', '1'};
+
+struct SectionEntry {
+    unsigned long long offset;
+    unsigned long long size;
+    unsigned long long stamp;  // 0 for base sections
+};
+
+struct Header {
+    char magic[8];
+    unsigned long long studentCount;
+    SectionEntry sections[NUM_SECTIONS];
+};
+
+// One fixed-size entry per student; name and marks live in their own sections
+struct Record {
+    int rollNo;
+    unsigned nameOffset;
+    unsigned marksOffset;
+    unsigned short nameLen;
+    unsigned short courseId;     // index into the course section
+    unsigned short numSubjects;
+    unsigned short reserved;
+};
+
+// Hash of the base sections, eight bytes at a time with four independent lanes
+inline unsigned long long hashBytes(const char* data, size_t size, unsigned long long seed) {
+    const unsigned long long K = 0x9E3779B97F4A7C15ull;
+    unsigned long long lane[4] = {seed, seed ^ 1, seed ^ 2, seed ^ 3};
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (int l = 0; l < 4; l++) {
+            unsigned long long word;
+            std::memcpy(&word, data + i + 8 * l, 8);
+            lane[l] = (lane[l] ^ word) * K;
+            lane[l] ^= lane[l] >> 29;
+        }
+    }
+    unsigned long long h = size;
+    for (int l = 0; l < 4; l++) h = (h ^ lane[l]) * K;
+    for (; i < size; i++) h = (h ^ static_cast<unsigned char>(data[i])) * K;
+    return h ^ (h >> 32);
+}
+
+// Stamp a derived section must carry to be valid for the given base data.
+// It covers the base hash, the section's format version and the section's
+// own bytes, so a damaged section is rebuilt rather than trusted. Grade codes
+// also depend on the absolute cut-offs, so the table is hashed in.
+inline unsigned long long derivedStamp(unsigned long long baseHash, unsigned section,
+                                       const char* payload, size_t size) {
+    unsigned long long stamp = hashBytes(reinterpret_cast<const char*>(&SECTION_VERSION[section]),
+                                         sizeof(SECTION_VERSION[section]), baseHash + section);
+    if (section == Grades) {
+        const auto& table = GradeTable<AbsoluteGrading>::codes;
+        stamp = hashBytes(reinterpret_cast<const char*>(table.data()), table.size(), stamp);
+    }
+    stamp = hashBytes(payload, size, stamp);
+    return stamp == 0 ? 1 : stamp;
+}
+
+template <typename T>
+void appendRaw(string& out, const T* items, size_t count) {
+    out.append(reinterpret_cast<const char*>(items), count * sizeof(T));
+}
+
+// Writes students and their (refreshed) derived data. The file is written
+// under a temporary name and renamed, so a crash never leaves half a snapshot.
+inline void save(const string& path, const vector<Student*>& students, DerivedStudentData& derived) {
+    derived.refresh(students);
+    
+    string sections[NUM_SECTIONS];
+    vector<Record> records(students.size());
+    vector<unsigned short> courseMap(StringPool::global().numCourses(), 0xFFFF);
+    vector<unsigned short> coursesUsed;
+    for (size_t i = 0; i < students.size(); i++) {
+        const Student& s = *students[i];
+        unsigned short poolId = s.getCourseId();
+        if (courseMap[poolId] == 0xFFFF) {
+            courseMap[poolId] = static_cast<unsigned short>(coursesUsed.size());
+            coursesUsed.push_back(poolId);
+        }
+        if (s.getName().size() > 0xFFFF || sections[Names].size() > 0xFFFFFFFFu ||
+            sections[Marks].size() > 0xFFFFFFFFu) {
+            throw runtime_error("Too much data for a snapshot");
+        }
+        Record& r = records[i];
+        r.rollNo = s.getRollNo();
+        r.nameOffset = static_cast<unsigned>(sections[Names].size());
+        r.marksOffset = static_cast<unsigned>(sections[Marks].size());
+        r.nameLen = static_cast<unsigned short>(s.getName().size());
+        r.courseId = courseMap[poolId];
+        r.numSubjects = static_cast<unsigned short>(s.getNumSubjects());
+        r.reserved = 0;
+        sections[Names].append(s.getName());
+        for (int j = 0; j < s.getNumSubjects(); j++) {
+            sections[Marks].push_back(static_cast<char>(s.getMarks(j)));
+        }
+    }
+    appendRaw(sections[Records], records.data(), records.size());
+    for (unsigned short poolId : coursesUsed) {
+        std::string_view name = StringPool::global().course(poolId);
+        unsigned short len = static_cast<unsigned short>(std::min<size_t>(name.size(), 0xFFFF));
+        appendRaw(sections[Courses], &len, 1);
+        sections[Courses].append(name.substr(0, len));
+    }
+    appendRaw(sections[Totals], derived.totals.data(), derived.totals.size());
+    appendRaw(sections[Grades], derived.gradeCodes.data(), derived.gradeCodes.size());
+    appendRaw(sections[Rank], derived.rankOrder.data(), derived.rankOrder.size());
+    appendRaw(sections[RollIndex], derived.rollIndex.data(), derived.rollIndex.size());
+    
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.studentCount = students.size();
+    unsigned long long baseHash = 0;
+    unsigned long long offset = sizeof(Header);
+    for (unsigned s = 0; s < NUM_SECTIONS; s++) {
+        offset = (offset + 7) & ~7ull;  // keep sections 8-byte aligned
+        header.sections[s].offset = offset;
+        header.sections[s].size = sections[s].size();
+        if (s < FIRST_DERIVED) {
+            baseHash = hashBytes(sections[s].data(), sections[s].size(), baseHash);
+            header.sections[s].stamp = 0;
+        } else {
+            header.sections[s].stamp = derivedStamp(baseHash, s, sections[s].data(), sections[s].size());
+        }
+        offset += sections[s].size();
+    }
+    
+    string temp = path + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw runtime_error("Cannot create " + temp);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        unsigned long long written = sizeof(Header);
+        for (unsigned s = 0; s < NUM_SECTIONS; s++) {
+            static const char zeros[8] = {};
+            out.write(zeros, static_cast<std::streamsize>(header.sections[s].offset - written));
+            out.write(sections[s].data(), static_cast<std::streamsize>(sections[s].size()));
+            written = header.sections[s].offset + sections[s].size();
+        }
+        if (!out.flush()) {
+            throw runtime_error("Cannot write " + temp);
+        }
+    }
+    if (std::rename(temp.c_str(), path.c_str()) != 0) {
+        std::remove(temp.c_str());
+        throw runtime_error("Cannot replace " + path);
+    }
+}
+
+struct LoadReport {
+    size_t students = 0;
+    vector<string> rebuilt;   // names of the derived sections that were stale
+    double mapMs = 0.0;       // map + validate + hash
+    double studentsMs = 0.0;  // create the Student objects
+    double derivedMs = 0.0;   // copy valid sections, rebuild stale ones
+    std::string_view nameBlock;  // pool block holding the loaded names
+};
+
+// Copies one derived section out of the mapping if its stamp is current and
+// its size fits; every value must pass the check or the section is rebuilt
+template <typename T, typename Check>
+bool loadDerived(const MappedFile& file, const Header& header, unsigned section,
+                 unsigned long long baseHash, vector<T>& out, Check valid) {
+    const SectionEntry& entry = header.sections[section];
+    if (entry.size != header.studentCount * sizeof(T) ||
+        entry.stamp != derivedStamp(baseHash, section, file.bytes() + entry.offset, entry.size)) {
+        return false;
+    }
+    out.resize(header.studentCount);
+    if (entry.size > 0) std::memcpy(out.data(), file.bytes() + entry.offset, entry.size);
+    for (const T& item : out) {
+        if (!valid(item)) return false;
+    }
+    return true;
+}
+
+// Loads a snapshot into an empty student list and its derived data
+inline LoadReport load(const string& path, vector<Student*>& students, DerivedStudentData& derived) {
+    typedef std::chrono::steady_clock Clock;
+    auto millis = [](Clock::time_point since) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+    };
+    LoadReport report;
+    auto start = Clock::now();
+    MappedFile file(path);
+    
+    Header header;
+    if (file.size() < sizeof(Header)) {
+        throw runtime_error(path + " is not a student snapshot");
+    }
+    std::memcpy(&header, file.bytes(), sizeof(Header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw runtime_error(path + " is not a student snapshot");
+    }
+    for (unsigned s = 0; s < NUM_SECTIONS; s++) {
+        const SectionEntry& e = header.sections[s];
+        if (e.offset > file.size() || e.size > file.size() - e.offset) {
+            throw runtime_error("Snapshot is truncated");
+        }
+    }
+    size_t n = static_cast<size_t>(header.studentCount);
+    if (header.sections[Records].size != n * sizeof(Record)) {
+        throw runtime_error("Snapshot is corrupt (record section)");
+    }
+    unsigned long long baseHash = 0;
+    for (unsigned s = 0; s < FIRST_DERIVED; s++) {
+        baseHash = hashBytes(file.bytes() + header.sections[s].offset, header.sections[s].size, baseHash);
+    }
+    
+    // Course table, interned into the pool once
+    vector<unsigned short> poolIds;
+    const char* courses = file.bytes() + header.sections[Courses].offset;
+    size_t coursesSize = header.sections[Courses].size;
+    for (size_t pos = 0; pos < coursesSize;) {
+        unsigned short len;
+        if (coursesSize - pos < sizeof(len)) throw runtime_error("Snapshot is corrupt (course section)");
+        std::memcpy(&len, courses + pos, sizeof(len));
+        pos += sizeof(len);
+        if (coursesSize - pos < len) throw runtime_error("Snapshot is corrupt (course section)");
+        poolIds.push_back(StringPool::global().internCourse(std::string_view(courses + pos, len)));
+        pos += len;
+    }
+    
+    // Check every record first, so that creating the students cannot fail halfway
+    const unsigned char* marks = reinterpret_cast<const unsigned char*>(file.bytes() + header.sections[Marks].offset);
+    // (sections are 8-byte aligned and the mapping is page aligned)
+    const Record* records = reinterpret_cast<const Record*>(file.bytes() + header.sections[Records].offset);
+    for (size_t i = 0; i < n; i++) {
+        const Record& r = records[i];
+        if (static_cast<unsigned long long>(r.nameOffset) + r.nameLen > header.sections[Names].size ||
+            static_cast<unsigned long long>(r.marksOffset) + r.numSubjects > header.sections[Marks].size ||
+            r.courseId >= poolIds.size()) {
+            throw runtime_error("Snapshot is corrupt (student " + std::to_string(r.rollNo) + ")");
+        }
+    }
+    for (size_t i = 0; i < header.sections[Marks].size; i++) {
+        if (marks[i] > 100) throw runtime_error("Snapshot is corrupt (marks section)");
+    }
+    report.mapMs = millis(start);
+    
+    // All names go into the pool as one block (released by the caller once
+    // these students are gone); the students are then created
+    // on several threads, each filling its own range of the list
+    start = Clock::now();
+    vector<Student*> loaded(n, nullptr);
+    vector<std::thread> workers;
+    std::string_view names = StringPool::global().storeBlock(
+        std::string_view(file.bytes() + header.sections[Names].offset, header.sections[Names].size));
+    // Until the students are handed over, a failure (creating them or
+    // rebuilding derived data) frees what was created so far and the names
+    try {
+        auto create = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                const Record& r = records[i];
+                Student* s = new Student(r.rollNo, names.substr(r.nameOffset, r.nameLen),
+                                         poolIds[r.courseId], r.numSubjects);
+                for (int j = 0; j < r.numSubjects; j++) {
+                    s->setMarks(j, marks[r.marksOffset + j]);
+                }
+                loaded[i] = s;
+            }
+        };
+        size_t numThreads = std::max(1u, std::min(8u, std::thread::hardware_concurrency()));
+        if (n < 65536) numThreads = 1;
+        vector<std::exception_ptr> errors(numThreads);
+        for (size_t t = 0; t < numThreads; t++) {
+            auto run = [&, t]() {
+                try {
+                    create(n * t / numThreads, n * (t + 1) / numThreads);
+                } catch (...) {
+                    errors[t] = std::current_exception();  // only std::bad_alloc
+                }
+            };
+            if (t + 1 < numThreads) {
+                workers.emplace_back(run);
+            } else {
+                run();
+            }
+        }
+        for (auto& w : workers) w.join();
+        for (auto& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+        report.studentsMs = millis(start);
+        
+        start = Clock::now();
+        derived.clear();
+        derived.scoresStale =
+            !loadDerived(file, header, Totals, baseHash, derived.totals, [](unsigned) { return true; }) ||
+            !loadDerived(file, header, Grades, baseHash, derived.gradeCodes,
+                         [](unsigned char c) { return c < AbsoluteGrading::numGrades; });
+        derived.rankStale = !loadDerived(file, header, Rank, baseHash, derived.rankOrder,
+                                         [n](unsigned p) { return p < n; });
+        derived.indexStale = !loadDerived(file, header, RollIndex, baseHash, derived.rollIndex,
+                                          [n](const RollIndexEntry& e) { return e.position < n; });
+        if (derived.scoresStale) report.rebuilt.push_back("totals & grade codes");
+        if (derived.rankStale) report.rebuilt.push_back(SECTION_NAMES[Rank]);
+        if (derived.indexStale) report.rebuilt.push_back(SECTION_NAMES[RollIndex]);
+        derived.refresh(loaded);
+        report.derivedMs = millis(start);
+    } catch (...) {
+        for (auto& w : workers) {
+            if (w.joinable()) w.join();
+        }
+        for (auto s : loaded) delete s;
+        StringPool::global().releaseBlock(names);
+        derived.clear();
+        throw;
+    }
+    
+    students.swap(loaded);
+    report.students = n;
+    report.nameBlock = names;
+    return report;
+}
+
+} // namespace snapshot
+
+// Saves generated students, then times startup loads with every derived
+// section valid, with only the rank order stale and with all of it stale
+int runSnapshotBenchmark(size_t numStudents) {
+    typedef std::chrono::steady_clock Clock;
+    auto millis = [](Clock::time_point since) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+    };
+    const char* courses[] = {"CS", "EE", "ME", "CE", "IT", "Civil", "Chem", "Bio"};
+    string file = "sms_snapshot_bench.snap";
+    int status = 0;
+    vector<Student*> students;
+    try {
+        unsigned int seed = 11;
+        for (size_t i = 0; i < numStudents; i++) {
+            Student* s = new Student(static_cast<int>(i + 1), "Student " + std::to_string(i + 1), courses[i % 8], 5);
+            students.push_back(s);
+            for (int j = 0; j < 5; j++) {
+                seed = seed * 1103515245u + 12345u;
+                s->setMarks(j, static_cast<int>(20 + (seed >> 16) % 81));
+            }
+        }
+        DerivedStudentData derived;
+        auto start = Clock::now();
+        snapshot::save(file, students, derived);
+        cout << "Saved " << numStudents << " students with derived data in " << fixed << setprecision(1)
+             << millis(start) << " ms" << endl;
+        for (auto s : students) delete s;
+        students.clear();
+        
+        // Zeroing a stamp makes that section stale, as if it came from an older version
+        auto invalidate = [&file](unsigned section) {
+            std::fstream patch(file, std::ios::in | std::ios::out | std::ios::binary);
+            unsigned long long zero = 0;
+            patch.seekp(offsetof(snapshot::Header, sections) + section * sizeof(snapshot::SectionEntry) +
+                        offsetof(snapshot::SectionEntry, stamp));
+            patch.write(reinterpret_cast<const char*>(&zero), sizeof(zero));
+        };
+        const char* runs[] = {"all derived data valid", "rank order stale", "all derived data stale"};
+        for (int run = 0; run < 3; run++) {
+            if (run == 1) invalidate(snapshot::Rank);
+            if (run == 2) {
+                for (unsigned s = snapshot::FIRST_DERIVED; s < snapshot::NUM_SECTIONS; s++) invalidate(s);
+            }
+            start = Clock::now();
+            snapshot::LoadReport report = snapshot::load(file, students, derived);
+            long position = derived.find(students, static_cast<int>(numStudents / 2 + 1));
+            const Student* top = students.empty() ? nullptr : students[derived.rankOrder[0]];
+            double ready = millis(start);
+            cout << "\n" << runs[run] << ":" << endl;
+            cout << "  map + hash " << report.mapMs << " ms, students " << report.studentsMs
+                 << " ms, derived " << report.derivedMs << " ms";
+            if (!report.rebuilt.empty()) {
+                cout << " (rebuilt";
+                for (auto& name : report.rebuilt) cout << ' ' << name << ';';
+                cout << ')';
+            }
+            cout << endl;
+            cout << "  first query ready after " << ready << " ms (roll " << numStudents / 2 + 1
+                 << (position >= 0 ? " found" : " missing") << ", top average "
+                 << setprecision(2) << (top ? top->getAverage() : 0.0) << setprecision(1) << ")" << endl;
+            for (auto s : students) delete s;
+            students.clear();
+            StringPool::global().releaseBlock(report.nameBlock);
+        }
+    } catch (const exception& e) {
+        cout << "✗ Error: " << e.what() << endl;
+        status = 1;
+    }
+    for (auto s : students) delete s;
+    std::remove(file.c_str());
+    return status;
+}
+
+// ==================== LOGIN RATE LIMITING (LOCK-FREE TOKEN BUCKETS) ====================
+enum class LoginStatus { Success, InvalidCredentials, RateLimited };
+
+// A table of token buckets, one per key (username or source), each packed
+// into a single 64-bit atomic: the top 40 bits hold the last refill time in
+// milliseconds, the low 24 bits the tokens in thousandths. An attempt takes one
+// token with a compare-and-swap loop, so no thread ever waits on a lock.
+// Keys are hashed into a fixed table; two keys sharing a bucket only make the
+// limit stricter for both.
+class RateLimiter {
+private:
+    static constexpr size_t NUM_BUCKETS = 4096;
+    static constexpr unsigned long long TOKEN = 1000;           // one token, fixed point
+    static constexpr unsigned long long TOKEN_MASK = (1ULL << 24) - 1;
+    
+    std::unique_ptr<std::atomic<unsigned long long>[]> buckets;
+    unsigned long long capacity;     // in thousandths of a token
+    unsigned long long refillPerMs;  // thousandths of a token per millisecond
+    std::chrono::steady_clock::time_point epoch;
+    
+    unsigned long long nowMs() const {
+        // +1 so that 0 can mean "bucket never used" (full)
+        return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - epoch).count()) + 1;
+    }
+    
+public:
+    // burst: attempts allowed at once; perSecond: sustained attempts per second
+    RateLimiter(unsigned burst, unsigned perSecond)
+        : buckets(new std::atomic<unsigned long long>[NUM_BUCKETS]),
+          capacity(std::min<unsigned long long>(burst * TOKEN, TOKEN_MASK)),
+          refillPerMs(std::max<unsigned long long>(perSecond * TOKEN / 1000, 1)),
+          epoch(std::chrono::steady_clock::now()) {
+        for (size_t i = 0; i < NUM_BUCKETS; i++) buckets[i] = 0;
+    }
+    
+    bool tryAcquire(const string& key) {
+        std::atomic<unsigned long long>& bucket = buckets[std::hash<string>()(key) % NUM_BUCKETS];
+        unsigned long long now = nowMs();
+        unsigned long long old = bucket.load(std::memory_order_relaxed);
+        while (true) {
+            unsigned long long last = old >> 24;
+            unsigned long long tokens = last == 0 ? capacity : (old & TOKEN_MASK);
+            if (last != 0 && now > last) {
+                tokens = std::min(capacity, tokens + (now - last) * refillPerMs);
+            }
+            if (tokens < TOKEN) return false;
+            unsigned long long updated = (std::max(now, last) << 24) | (tokens - TOKEN);
+            if (bucket.compare_exchange_weak(old, updated, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+    
+    // Gives back a token taken by tryAcquire, for attempts that should not
+    // count against the key (the bucket never grows past its burst size)
+    void refund(const string& key) {
+        std::atomic<unsigned long long>& bucket = buckets[std::hash<string>()(key) % NUM_BUCKETS];
+        unsigned long long now = nowMs();
+        unsigned long long old = bucket.load(std::memory_order_relaxed);
+        while (true) {
+            unsigned long long last = old >> 24;
+            if (last == 0) return;  // never used, so already full
+            unsigned long long tokens = old & TOKEN_MASK;
+            if (now > last) tokens += (now - last) * refillPerMs;
+            tokens = std::min(capacity, tokens + TOKEN);
+            unsigned long long updated = (std::max(now, last) << 24) | tokens;
+            if (bucket.compare_exchange_weak(old, updated, std::memory_order_relaxed)) return;
+        }
+    }
+};
+
+// ==================== MANAGEMENT SYSTEM CLASS ====================
+class ManagementSystem {
+private:
+    vector<Student*> students;  // Using pointers for dynamic polymorphism
+    vector<User*> users;
+    User* currentUser;
+    GradingScheme gradingScheme;
+    std::unique_ptr<AsyncExporter> exporter;  // at most one background export
+#if SMS_HAVE_POSIX
+    std::unique_ptr<ChangeFeed> changeFeed;   // null until started from the tools menu
+#endif
+    StudentColumns columns;                   // columnar copy for analytics queries
+    bool columnsStale;
+    RateLimiter userLimiter;                  // login attempts per username
+    RateLimiter sourceLimiter;                // login attempts per source (terminal, host)
+#if SMS_HAVE_POSIX
+    std::unique_ptr<PagedStudentStore> archive;  // optional on-disk archive
+#endif
+    DerivedStudentData derived;               // totals, grade codes, rank order, roll index
+    std::string_view snapshotNames;           // pool block of the last loaded snapshot
+    
+    void clearInputBuffer() {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    
+    // Looks a roll number up in the archive when it is not in memory
+    bool findArchived(int roll, Student& result) {
+#if SMS_HAVE_POSIX
+        ArchiveRecord record;
+        if (!archive || !archive->findRecord(roll, record)) return false;
+        result = record.toStudent();
+        return true;
+#else
+        (void)roll;
+        (void)result;
+        return false;
+#endif
+    }
+    
+    // Writes an archived student back after its marks changed
+    void storeArchived(const Student& student) {
+#if SMS_HAVE_POSIX
+        if (archive) archive->putStudent(student);
+#else
+        (void)student;
+#endif
+    }
+    
+    // Grade shown on marksheets, under the scheme the listings use
+    const char* gradeOf(const Student& student) const {
+        return gradeLabel(student, students, gradingScheme);
+    }
+    
+    // Every mutation goes through here: it updates or invalidates the derived
+    // data and the analytics columns and sends the change to the change feed,
+    // if one is running
+    void recordChange(ChangeType type, const Student& student) {
+        columnsStale = true;
+        if (type == ChangeType::StudentAdded) {
+            derived.studentAdded(students);
+        } else if (type == ChangeType::MarksEntered) {
+            derived.marksChanged(students, student);
+        }
+#if SMS_HAVE_POSIX
+        if (changeFeed && !changeFeed->record(ChangeEvent::fromStudent(type, student))) {
+            cout << "\n✗ Change feed stopped after a write error; this change was not published" << endl;
+        }
+#else
+        (void)type;
+        (void)student;
+#endif
+    }
+    
+    // Print a student table graded with the given policy. The list is always the
+    // whole cohort (possibly reordered), so relative grades rank every student.
+    // Grade codes already known for the rows are used instead of regrading.
+    template <typename Policy>
+    void printStudentTableFor(const vector<Student*>& list, const vector<unsigned char>* knownCodes) const {
+        vector<unsigned char> ownCodes;
+        if (knownCodes == nullptr) {
+            gradeCohort<Policy>(list, ownCodes);
+            knownCodes = &ownCodes;
+        }
+        const vector<unsigned char>& rowCodes = *knownCodes;
+        
+        cout << left << setw(10) << "Roll No" << setw(20) << "Name" 
+             << setw(15) << "Course" << setw(10) << "Average" << "Grade" << endl;
+        cout << string(65, '-') << endl;
+        
+        for (size_t i = 0; i < list.size(); i++) {
+            cout << left << setw(10) << list[i]->getRollNo() 
+                 << setw(20) << list[i]->getName()
+                 << setw(15) << list[i]->getCourse()
+                 << setw(10) << fixed << setprecision(2) << list[i]->getAverage()
+                 << Policy::labels[rowCodes[i]] << '\n';
+        }
+        cout << "Grading scheme: " << Policy::name << endl;
+    }
+    
+    // Pick the policy once, outside the per-student loop. absoluteCodes are
+    // the rows' precomputed AbsoluteGrading codes, if the caller has them.
+    void printStudentTable(const vector<Student*>& list,
+                           const vector<unsigned char>* absoluteCodes = nullptr) const {
+        switch (gradingScheme) {
+            case GradingScheme::Cgpa:
+                printStudentTableFor<CgpaGrading>(list, nullptr);
+                break;
+            case GradingScheme::PassFail:
+                printStudentTableFor<PassFailGrading>(list, nullptr);
+                break;
+            case GradingScheme::Relative:
+                printStudentTableFor<RelativeGrading>(list, nullptr);
+                break;
+            default:
+                printStudentTableFor<AbsoluteGrading>(list, absoluteCodes);
+        }
+    }
+    
+public:
+    // Constructor
+    ManagementSystem()
+        : currentUser(nullptr), gradingScheme(GradingScheme::Absolute), columnsStale(true),
+          userLimiter(5, 1), sourceLimiter(20, 5) {
+        // Initialize with default users
+        users.push_back(new Admin("admin", "admin123"));
+        users.push_back(new Teacher("teacher1", "teacher123", "Mathematics"));
+        users.push_back(new Teacher("teacher2", "teacher456", "Physics"));
+    }
+    
+    // Destructor - cleanup dynamic memory
+    ~ManagementSystem() {
+        for (auto student : students) {
+            delete student;
+        }
+        for (auto user : users) {
+            delete user;
+        }
+    }
+    
+    // Checks credentials without changing the session. Safe to call from
+    // several threads; rejected attempts cost no exception and no allocation
+    // beyond hashing the keys. Only failed attempts count against the limits:
+    // a successful login gives its tokens back, so logging in and out does
+    // not lock a user out.
+    LoginStatus checkLogin(const string& username, const string& password, const string& source,
+                           User** matched = nullptr) {
+        if (!sourceLimiter.tryAcquire(source) || !userLimiter.tryAcquire(username)) {
+            return LoginStatus::RateLimited;
+        }
+        for (auto user : users) {
+            if (user->authenticate(username, password)) {
+                if (matched != nullptr) *matched = user;
+                userLimiter.refund(username);
+                sourceLimiter.refund(source);
+                return LoginStatus::Success;
+            }
+        }
+        return LoginStatus::InvalidCredentials;
+    }
+    
+    // Login functionality
+    LoginStatus login(const string& username, const string& password, const string& source = "console") {
+        User* user = nullptr;
+        LoginStatus status = checkLogin(username, password, source, &user);
+        switch (status) {
+            case LoginStatus::Success:
+                currentUser = user;
+                cout << "\n✓ Login successful!" << endl;
+                currentUser->displayInfo();
+                break;
+            case LoginStatus::InvalidCredentials:
+                cout << "\n✗ Error: Invalid username or password" << endl;
+                break;
+            case LoginStatus::RateLimited:
+                cout << "\n✗ Error: Too many login attempts, please wait and try again" << endl;
+                break;
+        }
+        return status;
+    }
+    
+    void logout() {
+        currentUser = nullptr;
+        cout << "\n✓ Logged out successfully!" << endl;
+    }
+    
+    // Add new student
+    void addStudent() {
+        if (currentUser == nullptr || currentUser->getRole() != "Admin") {
+            cout << "\n✗ Only Admin can add students!" << endl;
+            return;
+        }
+        
+        try {
+            int roll, subjects;
+            string name, course;
+            
+            cout << "\n╔════════════════════════════════╗" << endl;
+            cout << "║        ADD NEW STUDENT         ║" << endl;
+            cout << "╚════════════════════════════════╝" << endl;
+            
+            cout << "Enter Roll Number: ";
+            cin >> roll;
+            clearInputBuffer();
+            
+            // Check if roll number already exists
+            if (findStudent(roll) != nullptr) {
+                throw runtime_error("Student with this roll number already exists");
+            }
+            
+            cout << "Enter Name: ";
+            getline(cin, name);
+            
+            cout << "Enter Course: ";
+            getline(cin, course);
+            
+            cout << "Enter number of subjects (default 5): ";
+            cin >> subjects;
+            clearInputBuffer();
+            
+            if (subjects <= 0) {
+                throw InvalidMarksException("Number of subjects must be positive");
+            }
+            
+            // Dynamic memory allocation
+            Student* newStudent = new Student(roll, name, course, subjects);
+            students.push_back(newStudent);
+            recordChange(ChangeType::StudentAdded, *newStudent);
+            
+            cout << "\n✓ Student added successfully!" << endl;
+        } catch (const exception& e) {
+            cout << "\n✗ Error: " << e.what() << endl;
+        }
+    }
+    
+    // Update student details
+    void updateStudent() {
+        if (currentUser == nullptr || currentUser->getRole() != "Admin") {
+            cout << "\n✗ Only Admin can update student details!" << endl;
+            return;
+        }
+        
+        try {
+            int roll;
+            cout << "\n╔════════════════════════════════╗" << endl;
+            cout << "║      UPDATE STUDENT DETAILS    ║" << endl;
+            cout << "╚════════════════════════════════╝" << endl;
+            cout << "Enter Roll Number: ";
+            cin >> roll;
+            clearInputBuffer();
+            
+            Student* student = findStudent(roll);
+            if (student == nullptr) {
+                throw StudentNotFoundException("Student not found");
+            }
+            
+            cout << "\nCurrent Details:" << endl;
+            student->displayInfo(gradeOf(*student));
+            
+            cout << "\nWhat do you want to update?" << endl;
+            cout << "1. Name" << endl;
+            cout << "2. Course" << endl;
+            cout << "3. Both" << endl;
+            cout << "Enter choice: ";
+            
+            int choice;
+            cin >> choice;
+            clearInputBuffer();
+            
+            string name, course;
+            
+            switch (choice) {
                 case 1:
                     cout << "Enter new name: ";
                     getline(cin, name);
@@ -589,8 +4006,9 @@ public:
                     return;
             }
             
+            recordChange(ChangeType::StudentUpdated, *student);
             cout << "\n✓ Student details updated successfully!" << endl;
-            student->displayInfo();
+            student->displayInfo(gradeOf(*student));
         } catch (const exception& e) {
             cout << "\n✗ Error: " << e.what() << endl;
         }
@@ -617,142 +4035,1235 @@ public:
             cin >> roll;
             clearInputBuffer();
             
+            Student archived;
+            Student* student = enterMarks(roll, archived, [&](const Student& s, int subject) {
+                if (subject == 0) {
+                    cout << "\nEntering marks for: " << s.getName()
+                         << (&s == &archived ? " (archived)" : "") << endl;
+                    cout << "Number of subjects: " << s.getNumSubjects() << endl;
+                }
+                int marks;
+                cout << "Enter marks for Subject " << (subject + 1) << " (0-100): ";
+                cin >> marks;
+                return marks;
+            });
+            clearInputBuffer();
+            
+            cout << "\n✓ Marks entered successfully!" << endl;
+            student->displayInfo(gradeOf(*student));
+        } catch (const exception& e) {
+            cout << "\n✗ Error: " << e.what() << endl;
+            clearInputBuffer();
+        }
+    }
+    
+    // Mark entry shared by conductExam and non-interactive callers. Students
+    // not in memory are looked up in the archive, loaded into scratch and
+    // written back. nextMark(student, subject) supplies each mark; when one
+    // is rejected the marks before it are kept and still published, then the
+    // error is rethrown. Returns the updated student (possibly &scratch).
+    template <typename NextMark>
+    Student* enterMarks(int roll, Student& scratch, NextMark nextMark) {
+        if (currentUser == nullptr ||
+            (currentUser->getRole() != "Admin" && currentUser->getRole() != "Teacher")) {
+            throw runtime_error("Only Admin or Teacher can enter marks");
+        }
+        
+        Student* student = findStudent(roll);
+        bool fromArchive = false;
+        if (student == nullptr && findArchived(roll, scratch)) {
+            student = &scratch;
+            fromArchive = true;
+        }
+        if (student == nullptr) {
+            throw StudentNotFoundException("Student not found");
+        }
+        
+        int entered = 0;
+        try {
+            for (int i = 0; i < student->getNumSubjects(); i++) {
+                student->setMarks(i, nextMark(static_cast<const Student&>(*student), i));
+                entered++;
+            }
+        } catch (const exception&) {
+            if (entered > 0) {
+                try {
+                    if (fromArchive) storeArchived(*student);
+                } catch (const exception& archiveError) {
+                    cout << "\n✗ Error: " << archiveError.what() << endl;
+                }
+                recordChange(ChangeType::MarksEntered, *student);
+            }
+            throw;
+        }
+        if (fromArchive) storeArchived(*student);
+        recordChange(ChangeType::MarksEntered, *student);
+        return student;
+    }
+    
+    // Search student by roll number
+    void searchStudent() {
+        try {
+            int roll;
+            cout << "\n╔════════════════════════════════╗" << endl;
+            cout << "║       SEARCH STUDENT           ║" << endl;
+            cout << "╚════════════════════════════════╝" << endl;
+            cout << "Enter Roll Number: ";
+            cin >> roll;
+            clearInputBuffer();
+            
             Student* student = findStudent(roll);
+            Student archived;
+            if (student == nullptr && findArchived(roll, archived)) {
+                cout << "\n(Found in archive)" << endl;
+                archived.displayInfo(gradeOf(archived));
+                return;
+            }
             if (student == nullptr) {
                 throw StudentNotFoundException("Student not found");
             }
             
-            cout << "\nEntering marks for: " << student->getName() << endl;
-            cout << "Number of subjects: " << student->getNumSubjects() << endl;
+            student->displayInfo(gradeOf(*student));
+        } catch (const exception& e) {
+            cout << "\n✗ Error: " << e.what() << endl;
+        }
+    }
+    
+    // Sort students by marks (average)
+    void sortStudentsByMarks() {
+        if (students.empty()) {
+            cout << "\n✗ No students in the system!" << endl;
+            return;
+        }
+        
+        cout << "\n╔════════════════════════════════╗" << endl;
+        cout << "║     SORT STUDENTS BY MARKS     ║" << endl;
+        cout << "╚════════════════════════════════╝" << endl;
+        cout << "1. Ascending Order" << endl;
+        cout << "2. Descending Order" << endl;
+        cout << "Enter choice: ";
+        
+        int choice;
+        cin >> choice;
+        clearInputBuffer();
+        
+        // Validate choice
+        if (choice != 1 && choice != 2) {
+            cout << "\n✗ Invalid choice! Please select 1 or 2." << endl;
+            return;
+        }
+        
+        // The rank order (best first, ties in list order) is kept as derived
+        // data and only re-sorted after marks change. Ascending order reverses
+        // the groups of equal averages but keeps each group in list order.
+        derived.refresh(students);
+        const vector<unsigned>& rank = derived.rankOrder;
+        vector<unsigned> order;
+        if (choice == 2) {
+            order = rank;
+        } else {
+            order.reserve(rank.size());
+            size_t end = rank.size();
+            while (end > 0) {
+                size_t begin = end - 1;
+                double average = derived.average(students, rank[begin]);
+                while (begin > 0 && derived.average(students, rank[begin - 1]) == average) begin--;
+                order.insert(order.end(), rank.begin() + begin, rank.begin() + end);
+                end = begin;
+            }
+        }
+        vector<Student*> sortedStudents(order.size());
+        vector<unsigned char> codes(order.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            sortedStudents[i] = students[order[i]];
+            codes[i] = derived.gradeCodes[order[i]];
+        }
+        
+        cout << "\n╔════════════════════════════════════════════════════════════╗" << endl;
+        cout << "║                    SORTED STUDENT LIST                     ║" << endl;
+        cout << "╚════════════════════════════════════════════════════════════╝" << endl;
+        printStudentTable(sortedStudents, &codes);
+    }
+    
+    // Display all students
+    void displayAllStudents() {
+        if (students.empty()) {
+            cout << "\n✗ No students in the system!" << endl;
+            return;
+        }
+        
+        cout << "\n╔════════════════════════════════════════════════════════════╗" << endl;
+        cout << "║                      ALL STUDENTS                          ║" << endl;
+        cout << "╚════════════════════════════════════════════════════════════╝" << endl;
+        derived.refresh(students);
+        printStudentTable(students, &derived.gradeCodes);
+    }
+    
+    // Generate marksheets for every student, one output file per course
+    void generateTranscripts() {
+        if (currentUser == nullptr) {
+            cout << "\n✗ Please login first!" << endl;
+            return;
+        }
+        if (students.empty()) {
+            cout << "\n✗ No students in the system!" << endl;
+            return;
+        }
+        
+        try {
+            cout << "\n╔════════════════════════════════╗" << endl;
+            cout << "║      GENERATE TRANSCRIPTS      ║" << endl;
+            cout << "╚════════════════════════════════╝" << endl;
+            cout << "1. Plain text" << endl;
+            cout << "2. HTML (printable)" << endl;
+            cout << "Enter choice: ";
             
-            for (int i = 0; i < student->getNumSubjects(); i++) {
-                int marks;
-                cout << "Enter marks for Subject " << (i + 1) << " (0-100): ";
-                cin >> marks;
-                
-                student->setMarks(i, marks);
+            int choice;
+            cin >> choice;
+            clearInputBuffer();
+            if (choice != 1 && choice != 2) {
+                cout << "\n✗ Invalid choice! Please select 1 or 2." << endl;
+                return;
             }
+            
+            string dir;
+            cout << "Output directory (blank for current): ";
+            getline(cin, dir);
+            
+            auto start = std::chrono::steady_clock::now();
+            TranscriptGenerator generator(students, gradingScheme,
+                choice == 2 ? TranscriptFormat::Html : TranscriptFormat::Text, dir);
+            size_t count = generator.generate();
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            
+            cout << "\n✓ " << count << " marksheets written to " << generator.getNumFiles()
+                 << " course file(s) in " << fixed << setprecision(2) << seconds << " s" << endl;
+        } catch (const exception& e) {
+            cout << "\n✗ Error: " << e.what() << endl;
+        }
+    }
+    
+    // Start a CSV export in the background and return to the menu at once
+    void startExport() {
+        if (currentUser == nullptr) {
+            cout << "\n✗ Please login first!" << endl;
+            return;
+        }
+        if (exporter && exporter->getState() == AsyncExporter::State::Running) {
+            cout << "\n✗ An export is already running! Check Export Status." << endl;
+            return;
+        }
+        
+        try {
+            cout << "\n╔════════════════════════════════╗" << endl;
+            cout << "║     EXPORT STUDENTS TO CSV     ║" << endl;
+            cout << "╚════════════════════════════════╝" << endl;
+            cout << "Output file (blank for students.csv): ";
+            string file;
+            getline(cin, file);
+            if (file.empty()) file = "students.csv";
+            
+            exporter.reset();  // joins the previous, finished export
+            exporter.reset(new AsyncExporter(students, gradingScheme, file));
+            cout << "\n✓ Export of " << exporter->getTotalRows()
+                 << " students started in the background" << endl;
+        } catch (const exception& e) {
+            cout << "\n✗ Error: " << e.what() << endl;
+        }
+    }
+    
+    void showExportStatus() {
+        if (!exporter) {
+            cout << "\n✗ No export has been started!" << endl;
+            return;
+        }
+        
+        size_t total = exporter->getTotalRows();
+        size_t done = exporter->getRowsFormatted();
+        double percent = total == 0 ? 100.0 : 100.0 * done / total;
+        cout << "\nExport to " << exporter->getPath() << ": ";
+        switch (exporter->getState()) {
+            case AsyncExporter::State::Running: cout << "running"; break;
+            case AsyncExporter::State::Done: cout << "complete"; break;
+            case AsyncExporter::State::Failed: cout << "failed (" << exporter->getError() << ")"; break;
+        }
+        cout << "\nRows formatted: " << done << " / " << total
+             << " (" << fixed << setprecision(1) << percent << "%)" << endl;
+        cout << "Bytes written: " << exporter->getBytesWritten() << endl;
+    }
+    
+    // Start (or show the status of) the change-data-capture feed
+    void manageChangeFeed() {
+        if (currentUser == nullptr || currentUser->getRole() != "Admin") {
+            cout << "\n✗ Only Admin can manage the change feed!" << endl;
+            return;
+        }
+#if SMS_HAVE_POSIX
+        if (changeFeed) {
+            cout << (changeFeed->hasFailed() ? "\n✗ Change feed stopped: writing the log failed"
+                                             : "\nChange feed is running") << endl;
+            cout << "Log file: " << changeFeed->getLogPath() << endl;
+            cout << "Socket: " << (changeFeed->getSocketPath().empty() ? string("(none)") : changeFeed->getSocketPath()) << endl;
+            cout << "Events published: " << changeFeed->getNextSequence() - 1 << endl;
+            cout << "Log size: " << changeFeed->getCommittedBytes() << " bytes" << endl;
+            return;
+        }
+        
+        try {
+            cout << "\n╔════════════════════════════════╗" << endl;
+            cout << "║      START CHANGE FEED         ║" << endl;
+            cout << "╚════════════════════════════════╝" << endl;
+            string log, socket;
+            cout << "Log file (blank for changes.cdc): ";
+            getline(cin, log);
+            if (log.empty()) log = "changes.cdc";
+            cout << "Unix socket for subscribers (blank for none): ";
+            getline(cin, socket);
+            
+            changeFeed.reset(new ChangeFeed(log, socket));
+            cout << "\n✓ Change feed started!" << endl;
+        } catch (const exception& e) {
+            cout << "\n✗ Error: " << e.what() << endl;
+        }
+#else
+        cout << "\n✗ The change feed needs a POSIX system!" << endl;
+#endif
+    }
+    
+    // Build a clash-free exam timetable and seating plan for all courses.
+    // Every (course, subject) pair is one paper sat by all students of the course.
+    void scheduleExams() {
+        if (currentUser == nullptr || currentUser->getRole() != "Admin") {
+            cout << "\n✗ Only Admin can schedule exams!" << endl;
+            return;
+        }
+        if (students.empty()) {
+            cout << "\n✗ No students in the system!" << endl;
+            return;
+        }
+        
+        try {
+            cout << "\n╔════════════════════════════════╗" << endl;
+            cout << "║   SCHEDULE EXAMS & SEATING     ║" << endl;
+            cout << "╚════════════════════════════════╝" << endl;
+            int numRooms, capacity;
+            cout << "Number of rooms: ";
+            cin >> numRooms;
+            cout << "Seats per room: ";
+            cin >> capacity;
             clearInputBuffer();
+            if (!cin || numRooms <= 0 || capacity <= 0) {
+                throw runtime_error("Rooms and seats must be positive");
+            }
             
-            cout << "\n✓ Marks entered successfully!" << endl;
-            student->displayInfo();
+            vector<Exam> papers;
+            std::map<std::pair<unsigned short, int>, int> paperIndex;
+            Enrollment enrollment;
+            vector<int> studentPapers;
+            for (auto student : students) {
+                studentPapers.clear();
+                for (int i = 0; i < student->getNumSubjects(); i++) {
+                    auto key = std::make_pair(student->getCourseId(), i);
+                    auto it = paperIndex.find(key);
+                    if (it == paperIndex.end()) {
+                        it = paperIndex.insert({key, static_cast<int>(papers.size())}).first;
+                        string course(student->getCourse());
+                        papers.push_back(Exam(course + " - Subject " + std::to_string(i + 1), "", 100, course, i));
+                    }
+                    studentPapers.push_back(it->second);
+                }
+                enrollment.addStudent(studentPapers);
+            }
+            
+            vector<Room> rooms;
+            for (int r = 0; r < numRooms; r++) {
+                rooms.push_back({"Room " + std::to_string(r + 1), capacity});
+            }
+            ExamScheduler scheduler(papers.size(), rooms);
+            int numSlots = scheduler.schedule(enrollment);
+            
+            cout << "\n✓ " << papers.size() << " papers scheduled in " << numSlots << " slots" << endl;
+            for (int slot = 0; slot < numSlots; slot++) {
+                cout << "\n" << ExamScheduler::slotLabel(slot) << endl;
+                cout << string(60, '-') << endl;
+                for (auto& block : scheduler.getSeating(slot)) {
+                    Exam& paper = papers[block.paper];
+                    paper.setExamDate(ExamScheduler::slotLabel(slot));
+                    cout << left << setw(30) << paper.getExamName() << setw(12)
+                         << scheduler.getRoom(block.room).name << "seats " << (block.firstSeat + 1)
+                         << "-" << (block.firstSeat + block.count) << endl;
+                }
+            }
+        } catch (const exception& e) {
+            cout << "\n✗ Error: " << e.what() << endl;
+        }
+    }
+    
+    // Run an analytics query over all students
+    void runAnalyticsQuery() {
+        if (currentUser == nullptr) {
+            cout << "\n✗ Please login first!" << endl;
+            return;
+        }
+        
+        try {
+            cout << "\n╔════════════════════════════════════════════════════════════╗" << endl;
+            cout << "║                     ANALYTICS QUERY                        ║" << endl;
+            cout << "╚════════════════════════════════════════════════════════════╝" << endl;
+            cout << "Syntax: [where <cond> [and <cond>]...] [by course|grade] [aggregates]" << endl;
+            cout << "  cond: course=CS grade=A avg>=60 mark3<35 anymark<35" << endl;
+            cout << "  aggregates: count avg(x) min(x) max(x) p90(x) passrate(x,50)  (x = avg or markN)" << endl;
+            cout << "  no aggregates lists the matching students" << endl;
+            cout << "Example: by course passrate(mark3,50)" << endl;
+            cout << "Query: ";
+            string text;
+            getline(cin, text);
+            
+            if (columnsStale) {
+                columns.build(students);
+                columnsStale = false;
+            }
+            QueryEngine engine(columns);
+            auto start = std::chrono::steady_clock::now();
+            QueryResult result = engine.run(QueryEngine::parse(text, columns));
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            cout << endl;
+            printQueryResult(result);
+            cout << "Query time: " << fixed << setprecision(2) << ms << " ms" << endl;
+        } catch (const std::logic_error& e) {
+            cout << "\n✗ Error: invalid number in query" << endl;
+        } catch (const exception& e) {
+            cout << "\n✗ Error: " << e.what() << endl;
+        }
+    }
+    
+    // Replace the students with the ones in a snapshot file. Derived data
+    // whose stamp still matches is taken from the file; the rest is rebuilt.
+    bool loadSnapshot(const string& path) {
+        try {
+            vector<Student*> loaded;
+            // load frees the students and names it created if it fails; once
+            // it returns, taking them over below cannot throw
+            snapshot::LoadReport report = snapshot::load(path, loaded, derived);
+            students.swap(loaded);
+            for (auto student : loaded) delete student;
+            // The replaced students were the only users of the previous block
+            // (exports and change events copy names)
+            StringPool::global().releaseBlock(snapshotNames);
+            snapshotNames = report.nameBlock;
+            columnsStale = true;
+            
+            cout << "\n✓ Loaded " << report.students << " students from " << path << " in "
+                 << fixed << setprecision(1) << report.mapMs + report.studentsMs + report.derivedMs
+                 << " ms" << endl;
+            if (report.rebuilt.empty()) {
+                cout << "  Derived data (totals, grades, rank order, roll index) taken from the snapshot" << endl;
+            } else {
+                cout << "  Rebuilt stale derived data:";
+                for (auto& name : report.rebuilt) cout << ' ' << name << ';';
+                cout << endl;
+            }
+            return true;
+        } catch (const exception& e) {
+            // derived may hold partly loaded data for a list that was never installed
+            derived.clear();
+            cout << "\n✗ Error: " << e.what() << endl;
+            return false;
+        }
+    }
+    
+    // Save the students with their derived data, or load a saved snapshot
+    void manageSnapshot() {
+        if (currentUser == nullptr || currentUser->getRole() != "Admin") {
+            cout << "\n✗ Only Admin can save or load snapshots!" << endl;
+            return;
+        }
+        
+        cout << "\n╔════════════════════════════════╗" << endl;
+        cout << "║        STUDENT SNAPSHOT        ║" << endl;
+        cout << "╚════════════════════════════════╝" << endl;
+        cout << "1. Save Snapshot" << endl;
+        cout << "2. Load Snapshot (replaces current students)" << endl;
+        cout << "Enter choice: ";
+        
+        int choice;
+        cin >> choice;
+        clearInputBuffer();
+        if (choice != 1 && choice != 2) {
+            cout << "\n✗ Invalid choice! Please select 1 or 2." << endl;
+            return;
+        }
+        
+        string file;
+        cout << "Snapshot file (blank for students.snap): ";
+        getline(cin, file);
+        if (file.empty()) file = "students.snap";
+        
+        if (choice == 2) {
+            loadSnapshot(file);
+            return;
+        }
+        try {
+            auto start = std::chrono::steady_clock::now();
+            snapshot::save(file, students, derived);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            cout << "\n✓ " << students.size() << " students saved to " << file << " in "
+                 << fixed << setprecision(1) << ms << " ms" << endl;
         } catch (const exception& e) {
             cout << "\n✗ Error: " << e.what() << endl;
-            clearInputBuffer();
         }
     }
     
-    // Search student by roll number
-    void searchStudent() {
+    // Open an on-disk archive, copy students into it or scan it
+    void manageArchive() {
+        if (currentUser == nullptr || currentUser->getRole() != "Admin") {
+            cout << "\n✗ Only Admin can manage the archive!" << endl;
+            return;
+        }
+#if SMS_HAVE_POSIX
         try {
-            int roll;
             cout << "\n╔════════════════════════════════╗" << endl;
-            cout << "║       SEARCH STUDENT           ║" << endl;
+            cout << "║        STUDENT ARCHIVE         ║" << endl;
             cout << "╚════════════════════════════════╝" << endl;
-            cout << "Enter Roll Number: ";
-            cin >> roll;
+            if (archive) {
+                cout << "Open: " << archive->getPath() << " (" << archive->size() << " students)" << endl;
+            }
+            cout << "1. Open / Create Archive" << endl;
+            cout << "2. Copy Current Students into Archive" << endl;
+            cout << "3. Archive Statistics (full scan)" << endl;
+            cout << "Enter choice: ";
+            
+            int choice;
+            cin >> choice;
             clearInputBuffer();
             
-            Student* student = findStudent(roll);
-            if (student == nullptr) {
-                throw StudentNotFoundException("Student not found");
+            if (choice == 1) {
+                string file;
+                size_t budgetMB;
+                cout << "Archive file (blank for students.archive): ";
+                getline(cin, file);
+                if (file.empty()) file = "students.archive";
+                cout << "Memory budget in MB: ";
+                cin >> budgetMB;
+                clearInputBuffer();
+                if (!cin || budgetMB == 0) {
+                    throw runtime_error("Memory budget must be positive");
+                }
+                archive.reset();  // flush the previous archive first
+                archive.reset(new PagedStudentStore(file, budgetMB * 1024 * 1024));
+                cout << "\n✓ Archive opened with " << archive->size() << " students" << endl;
+                cout << "Search and mark entry now also look in the archive." << endl;
+            } else if (choice == 2 || choice == 3) {
+                if (!archive) {
+                    throw runtime_error("Open an archive first");
+                }
+                if (choice == 2) {
+                    size_t copied = 0;
+                    for (auto student : students) {
+                        try {
+                            archive->putStudent(*student);
+                            copied++;
+                        } catch (const runtime_error& e) {
+                            cout << "✗ Roll " << student->getRollNo() << " skipped: " << e.what() << endl;
+                        }
+                    }
+                    archive->flush();
+                    cout << "\n✓ " << copied << " students copied into the archive" << endl;
+                } else {
+                    printArchiveStats(*archive);
+                }
+            } else {
+                cout << "\n✗ Invalid choice!" << endl;
             }
-            
-            student->displayInfo();
         } catch (const exception& e) {
             cout << "\n✗ Error: " << e.what() << endl;
         }
+#else
+        cout << "\n✗ The archive needs a POSIX system!" << endl;
+#endif
     }
     
-    // Sort students by marks (average)
-    void sortStudentsByMarks() {
-        if (students.empty()) {
-            cout << "\n✗ No students in the system!" << endl;
+    void showMemoryReport() const {
+        printMemoryReport(students);
+    }
+    
+    // Choose the grading scheme used by the student listings
+    void changeGradingScheme() {
+        if (currentUser == nullptr || currentUser->getRole() != "Admin") {
+            cout << "\n✗ Only Admin can change the grading scheme!" << endl;
             return;
         }
         
         cout << "\n╔════════════════════════════════╗" << endl;
-        cout << "║     SORT STUDENTS BY MARKS     ║" << endl;
+        cout << "║     CHANGE GRADING SCHEME      ║" << endl;
         cout << "╚════════════════════════════════╝" << endl;
-        cout << "1. Ascending Order" << endl;
-        cout << "2. Descending Order" << endl;
+        cout << "1. " << AbsoluteGrading::name << endl;
+        cout << "2. " << CgpaGrading::name << endl;
+        cout << "3. " << PassFailGrading::name << endl;
+        cout << "4. " << RelativeGrading::name << endl;
         cout << "Enter choice: ";
         
         int choice;
         cin >> choice;
         clearInputBuffer();
         
-        // Validate choice
-        if (choice != 1 && choice != 2) {
-            cout << "\n✗ Invalid choice! Please select 1 or 2." << endl;
-            return;
+        switch (choice) {
+            case 1: gradingScheme = GradingScheme::Absolute; break;
+            case 2: gradingScheme = GradingScheme::Cgpa; break;
+            case 3: gradingScheme = GradingScheme::PassFail; break;
+            case 4: gradingScheme = GradingScheme::Relative; break;
+            default:
+                cout << "\n✗ Invalid choice!" << endl;
+                return;
         }
+        cout << "\n✓ Grading scheme updated!" << endl;
+    }
+    
+    // Helper function to find student by roll number (binary search in the roll index)
+    Student* findStudent(int roll) {
+        long position = derived.find(students, roll);
+        return position < 0 ? nullptr : students[position];
+    }
+    
+    User* getCurrentUser() const { return currentUser; }
+};
+
+// ==================== SHARDING (MULTI-PROCESS, UNIX SOCKETS) ====================
+// Splits the student store across several local processes. Each shard server
+// owns the students in its roll-number range (or hash bucket) and answers a
+// small line-based protocol; ShardRouter sends each query to the right shard,
+// or to all of them, and merges the answers. This is a standalone tool driven
+// by --shard-server and --shard-demo; ManagementSystem keeps its students in
+// process and does not go through the router.
+//
+// Protocol (one request per line, fields separated by tabs):
+//   LOAD <n>   followed by n student lines  -> OK <n>
+//   FIND <roll>                             -> ROW <student> | NONE
+//   LIST                                    -> ROW <student> ... END
+//   TOPK <k>                                -> ROW <student> ... END
+//   STATS                                   -> STATS <count> <sum> <min> <max>
+//   QUIT                                    -> server exits
+// A student line is: roll, name, course, comma-separated marks.
+
+enum class ShardingMode { Range, Hash };
+
+// Split a protocol line on tabs
+inline vector<string> splitFields(const string& line) {
+    vector<string> fields;
+    size_t start = 0;
+    while (true) {
+        size_t tab = line.find('\t', start);
+        fields.push_back(line.substr(start, tab == string::npos ? string::npos : tab - start));
+        if (tab == string::npos) break;
+        start = tab + 1;
+    }
+    return fields;
+}
+
+// Tabs and newlines would break the framing, so they become spaces
+inline string wireSafe(std::string_view text) {
+    string out(text);
+    for (char& c : out) {
+        if (c == '\t' || c == '\n' || c == '\r') c = ' ';
+    }
+    return out;
+}
+
+inline string encodeStudent(const Student& s) {
+    string line = std::to_string(s.getRollNo()) + '\t' + wireSafe(s.getName()) + '\t' +
+                  wireSafe(s.getCourse()) + '\t';
+    for (int i = 0; i < s.getNumSubjects(); i++) {
+        if (i > 0) line += ',';
+        line += std::to_string(s.getMarks(i));
+    }
+    return line;
+}
+
+// Decodes fields[first..first+3] back into a Student
+inline Student decodeStudent(const vector<string>& fields, size_t first) {
+    if (fields.size() < first + 4) {
+        throw runtime_error("Malformed student record");
+    }
+    vector<int> marks;
+    std::istringstream in(fields[first + 3]);
+    string mark;
+    while (getline(in, mark, ',')) {
+        if (!mark.empty()) marks.push_back(std::stoi(mark));
+    }
+    Student s(std::stoi(fields[first]), fields[first + 1], fields[first + 2],
+              static_cast<int>(marks.size()), OwnedName());
+    for (size_t i = 0; i < marks.size(); i++) {
+        s.setMarks(static_cast<int>(i), marks[i]);
+    }
+    return s;
+}
+
+#if SMS_HAVE_POSIX
+// Buffered line reader/writer over a connected socket
+class LineChannel {
+private:
+    int fd;
+    string readBuffer;
+    size_t readPos;
+    string writeBuffer;
+    
+public:
+    explicit LineChannel(int socketFd) : fd(socketFd), readPos(0) {}
+    ~LineChannel() { ::close(fd); }
+    
+    LineChannel(const LineChannel&) = delete;
+    LineChannel& operator=(const LineChannel&) = delete;
+    
+    // Lines are queued and only sent by flush(), so a batch costs one syscall
+    void writeLine(const string& line) {
+        writeBuffer += line;
+        writeBuffer += '\n';
+        if (writeBuffer.size() >= 64 * 1024) flush();
+    }
+    
+    // A peer that has gone away is reported as an error, not by SIGPIPE
+    void flush() {
+#ifdef MSG_NOSIGNAL
+        const int flags = MSG_NOSIGNAL;
+#else
+        const int flags = 0;
+#endif
+        size_t sent = 0;
+        while (sent < writeBuffer.size()) {
+            ssize_t n = ::send(fd, writeBuffer.data() + sent, writeBuffer.size() - sent, flags);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) throw runtime_error("Shard connection lost while writing");
+            sent += static_cast<size_t>(n);
+        }
+        writeBuffer.clear();
+    }
+    
+    // Returns false when the peer has closed the connection
+    bool readLine(string& line) {
+        while (true) {
+            size_t newline = readBuffer.find('\n', readPos);
+            if (newline != string::npos) {
+                line.assign(readBuffer, readPos, newline - readPos);
+                readPos = newline + 1;
+                return true;
+            }
+            readBuffer.erase(0, readPos);
+            readPos = 0;
+            char chunk[64 * 1024];
+            ssize_t n = ::read(fd, chunk, sizeof(chunk));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            readBuffer.append(chunk, static_cast<size_t>(n));
+        }
+    }
+    
+    string expectLine() {
+        string line;
+        if (!readLine(line)) throw runtime_error("Shard connection closed");
+        return line;
+    }
+};
+
+// One shard: owns a slice of the students and answers protocol requests
+class ShardServer {
+private:
+    std::map<int, std::unique_ptr<Student>> students;  // ordered by roll number
+    
+    static void sendStats(LineChannel& channel, const CohortStats& stats) {
+        std::ostringstream line;
+        line << std::setprecision(17) << "STATS\t" << stats.count << '\t' << stats.sumAverage
+             << '\t' << stats.minAverage << '\t' << stats.maxAverage;
+        channel.writeLine(line.str());
+    }
+    
+    // Returns false when the server should stop
+    bool handle(LineChannel& channel, const string& request) {
+        vector<string> fields = splitFields(request);
+        const string& command = fields[0];
         
-        // Create a copy of the vector for sorting
-        vector<Student*> sortedStudents = students;
-        
-        // Using template function for sorting
-        if (choice == 1) {
-            bubbleSort<Student>(sortedStudents, [](Student* a, Student* b) {
-                return a->getAverage() > b->getAverage();
-            });
+        if (command == "LOAD" && fields.size() == 2) {
+            // Every line of the batch is read even if one is bad, so the
+            // router gets exactly one reply and the stream stays in step.
+            // A batch with a bad line is rejected as a whole.
+            size_t n = std::stoul(fields[1]);
+            vector<std::unique_ptr<Student>> batch;
+            string error;
+            for (size_t i = 0; i < n; i++) {
+                string line = channel.expectLine();
+                if (!error.empty()) continue;
+                try {
+                    batch.emplace_back(new Student(decodeStudent(splitFields(line), 0)));
+                } catch (const exception& e) {
+                    error = "line " + std::to_string(i + 1) + " of LOAD: " + e.what();
+                }
+            }
+            if (!error.empty()) {
+                throw runtime_error(error);
+            }
+            for (auto& student : batch) {
+                int roll = student->getRollNo();
+                students[roll] = std::move(student);
+            }
+            channel.writeLine("OK\t" + std::to_string(n));
+        } else if (command == "FIND" && fields.size() == 2) {
+            auto it = students.find(std::stoi(fields[1]));
+            channel.writeLine(it == students.end() ? string("NONE") : "ROW\t" + encodeStudent(*it->second));
+        } else if (command == "LIST") {
+            for (auto& entry : students) {
+                channel.writeLine("ROW\t" + encodeStudent(*entry.second));
+            }
+            channel.writeLine("END");
+        } else if (command == "TOPK" && fields.size() == 2) {
+            size_t k = std::min<size_t>(std::stoul(fields[1]), students.size());
+            vector<const Student*> all;
+            all.reserve(students.size());
+            for (auto& entry : students) all.push_back(entry.second.get());
+            std::partial_sort(all.begin(), all.begin() + k, all.end(),
+                [](const Student* a, const Student* b) { return a->getAverage() > b->getAverage(); });
+            for (size_t i = 0; i < k; i++) {
+                channel.writeLine("ROW\t" + encodeStudent(*all[i]));
+            }
+            channel.writeLine("END");
+        } else if (command == "STATS") {
+            CohortStats stats;
+            for (auto& entry : students) {
+                CohortStats one;
+                one.count = 1;
+                one.sumAverage = one.minAverage = one.maxAverage = entry.second->getAverage();
+                stats.merge(one);
+            }
+            sendStats(channel, stats);
+        } else if (command == "QUIT") {
+            return false;
         } else {
-            bubbleSort<Student>(sortedStudents, [](Student* a, Student* b) {
-                return a->getAverage() < b->getAverage();
-            });
+            channel.writeLine("ERR\tUnknown request");
+        }
+        channel.flush();
+        return true;
+    }
+    
+public:
+    // Listen on a Unix socket and serve routers until a QUIT arrives
+    void serve(const string& socketPath) {
+        int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0) throw runtime_error("Cannot create socket");
+        sockaddr_un addr = unixAddress(socketPath);
+        ::unlink(socketPath.c_str());
+        if (::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+            ::listen(listenFd, 8) < 0) {
+            ::close(listenFd);
+            throw runtime_error("Cannot listen on " + socketPath);
         }
         
-        cout << "\n╔════════════════════════════════════════════════════════════╗" << endl;
-        cout << "║                    SORTED STUDENT LIST                     ║" << endl;
-        cout << "╚════════════════════════════════════════════════════════════╝" << endl;
-        cout << left << setw(10) << "Roll No" << setw(20) << "Name" 
-             << setw(15) << "Course" << setw(10) << "Average" << "Grade" << endl;
-        cout << string(65, '-') << endl;
+        bool running = true;
+        while (running) {
+            int fd = ::accept(listenFd, nullptr, nullptr);
+            if (fd < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            LineChannel channel(fd);
+            string request;
+            while (running && channel.readLine(request)) {
+                try {
+                    running = handle(channel, request);
+                } catch (const exception& e) {
+                    try {
+                        channel.writeLine(string("ERR\t") + e.what());
+                        channel.flush();
+                    } catch (const exception&) {
+                        break;  // the router has gone away
+                    }
+                }
+            }
+        }
+        ::close(listenFd);
+        ::unlink(socketPath.c_str());
+    }
+};
+
+// Routes requests to the shard servers and merges their answers
+class ShardRouter {
+private:
+    vector<std::unique_ptr<LineChannel>> shards;
+    ShardingMode mode;
+    int rangeWidth;
+    
+    static int connectTo(const string& path) {
+        sockaddr_un addr = unixAddress(path);
+        // The shard may still be starting up, so retry for a short while
+        for (int attempt = 0; attempt < 200; attempt++) {
+            int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd < 0) break;
+            if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+                return fd;
+            }
+            ::close(fd);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        throw runtime_error("Cannot connect to shard at " + path);
+    }
+    
+    static void checkError(const string& line) {
+        if (line.compare(0, 3, "ERR") == 0) {
+            throw runtime_error("Shard error: " + line.substr(line.find('\t') + 1));
+        }
+    }
+    
+    // Fan-out replies are always read from every shard before anything is
+    // thrown, so no channel is left holding an unread answer. Only the first
+    // error is kept.
+    static void noteError(string& firstError, const string& line) {
+        if (firstError.empty() && line.compare(0, 3, "ERR") == 0) {
+            firstError = "Shard error: " + line.substr(line.find('\t') + 1);
+        }
+    }
+    
+    static void throwIfError(const string& firstError) {
+        if (!firstError.empty()) throw runtime_error(firstError);
+    }
+    
+    // Send the same request to every shard before reading any reply, so the
+    // shards work in parallel
+    void broadcast(const string& request) {
+        for (auto& shard : shards) {
+            shard->writeLine(request);
+            shard->flush();
+        }
+    }
+    
+    // Reads one row reply up to its END (or an ERR, which ends it too).
+    // Rows that fail to decode are skipped so the rest is still drained.
+    vector<Student> readRows(LineChannel& shard, string& firstError) {
+        vector<Student> rows;
+        while (true) {
+            string line = shard.expectLine();
+            if (line == "END") return rows;
+            if (line.compare(0, 3, "ERR") == 0) {
+                noteError(firstError, line);
+                return rows;
+            }
+            try {
+                rows.push_back(decodeStudent(splitFields(line), 1));
+            } catch (const exception& e) {
+                if (firstError.empty()) firstError = string("Malformed shard row: ") + e.what();
+            }
+        }
+    }
+    
+public:
+    // rangeWidth is the number of roll numbers per shard in Range mode
+    ShardRouter(const vector<string>& socketPaths, ShardingMode m, int width = 100000)
+        : mode(m), rangeWidth(width > 0 ? width : 1) {
+        for (auto& path : socketPaths) {
+            shards.emplace_back(new LineChannel(connectTo(path)));
+        }
+    }
+    
+    size_t getNumShards() const { return shards.size(); }
+    
+    size_t shardFor(int roll) const {
+        if (mode == ShardingMode::Range) {
+            long index = roll < 0 ? 0 : roll / rangeWidth;
+            return std::min(static_cast<size_t>(index), shards.size() - 1);
+        }
+        // Multiplicative hash so consecutive roll numbers spread out
+        unsigned int h = static_cast<unsigned int>(roll) * 2654435761u;
+        return h % shards.size();
+    }
+    
+    // Bulk load: one LOAD batch per shard
+    void addStudents(const vector<Student*>& students) {
+        vector<vector<const Student*>> perShard(shards.size());
+        for (auto student : students) {
+            perShard[shardFor(student->getRollNo())].push_back(student);
+        }
+        for (size_t i = 0; i < shards.size(); i++) {
+            shards[i]->writeLine("LOAD\t" + std::to_string(perShard[i].size()));
+            for (auto student : perShard[i]) {
+                shards[i]->writeLine(encodeStudent(*student));
+            }
+            shards[i]->flush();
+        }
+        string firstError;
+        for (auto& shard : shards) {
+            noteError(firstError, shard->expectLine());
+        }
+        throwIfError(firstError);
+    }
+    
+    // Roll numbers map to exactly one shard, so no fan-out is needed
+    bool findStudent(int roll, Student& result) {
+        LineChannel& shard = *shards[shardFor(roll)];
+        shard.writeLine("FIND\t" + std::to_string(roll));
+        shard.flush();
+        string line = shard.expectLine();
+        checkError(line);
+        if (line == "NONE") return false;
+        result = decodeStudent(splitFields(line), 1);
+        return true;
+    }
+    
+    // All students ordered by roll number (k-way merge of sorted shard lists)
+    vector<Student> listStudents() {
+        broadcast("LIST");
+        vector<vector<Student>> lists;
+        string firstError;
+        for (auto& shard : shards) {
+            lists.push_back(readRows(*shard, firstError));
+        }
+        throwIfError(firstError);
         
-        for (auto student : sortedStudents) {
-            cout << left << setw(10) << student->getRollNo() 
-                 << setw(20) << student->getName()
-                 << setw(15) << student->getCourse()
-                 << setw(10) << fixed << setprecision(2) << student->getAverage()
-                 << student->getGrade() << endl;
+        vector<Student> merged;
+        vector<size_t> pos(lists.size(), 0);
+        while (true) {
+            size_t best = lists.size();
+            for (size_t i = 0; i < lists.size(); i++) {
+                if (pos[i] < lists[i].size() &&
+                    (best == lists.size() || lists[i][pos[i]].getRollNo() < lists[best][pos[best]].getRollNo())) {
+                    best = i;
+                }
+            }
+            if (best == lists.size()) break;
+            merged.push_back(lists[best][pos[best]++]);
         }
+        return merged;
     }
     
-    // Display all students
-    void displayAllStudents() {
-        if (students.empty()) {
-            cout << "\n✗ No students in the system!" << endl;
-            return;
+    // Each shard returns its own top k; the global top k is among those
+    vector<Student> topK(size_t k) {
+        broadcast("TOPK\t" + std::to_string(k));
+        vector<Student> candidates;
+        string firstError;
+        for (auto& shard : shards) {
+            vector<Student> rows = readRows(*shard, firstError);
+            candidates.insert(candidates.end(), rows.begin(), rows.end());
+        }
+        throwIfError(firstError);
+        k = std::min(k, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + k, candidates.end(),
+            [](const Student& a, const Student& b) { return a.getAverage() > b.getAverage(); });
+        candidates.resize(k, Student());
+        return candidates;
+    }
+    
+    CohortStats statistics() {
+        broadcast("STATS");
+        CohortStats total;
+        string firstError;
+        for (auto& shard : shards) {
+            string line = shard->expectLine();
+            noteError(firstError, line);
+            if (!firstError.empty()) continue;
+            vector<string> fields = splitFields(line);
+            try {
+                if (fields.size() != 5) throw runtime_error("wrong field count");
+                CohortStats part;
+                part.count = std::stoul(fields[1]);
+                part.sumAverage = std::stod(fields[2]);
+                part.minAverage = std::stod(fields[3]);
+                part.maxAverage = std::stod(fields[4]);
+                total.merge(part);
+            } catch (const exception& e) {
+                firstError = string("Malformed STATS reply: ") + e.what();
+            }
+        }
+        throwIfError(firstError);
+        return total;
+    }
+    
+    void shutdown() {
+        broadcast("QUIT");
+    }
+};
+
+// Starts numShards shard servers as child processes, loads generated
+// students through the router and times the fanned-out queries
+int runShardDemo(size_t numShards, size_t numStudents, ShardingMode mode) {
+    if (numShards == 0) numShards = 1;
+    vector<string> paths;
+    vector<pid_t> children;
+    for (size_t i = 0; i < numShards; i++) {
+        paths.push_back("/tmp/sms_shard_" + std::to_string(::getpid()) + "_" + std::to_string(i) + ".sock");
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            try {
+                ShardServer server;
+                server.serve(paths.back());
+            } catch (const exception& e) {
+                std::cerr << "Shard " << i << ": " << e.what() << endl;
+                ::_exit(1);
+            }
+            ::_exit(0);
+        }
+        if (pid < 0) {
+            cout << "✗ Error: fork failed" << endl;
+            return 1;
         }
+        children.push_back(pid);
+    }
+    
+    int status = 0;
+    try {
+        typedef std::chrono::steady_clock Clock;
+        auto seconds = [](Clock::time_point since) {
+            return std::chrono::duration<double>(Clock::now() - since).count();
+        };
         
-        cout << "\n╔════════════════════════════════════════════════════════════╗" << endl;
-        cout << "║                      ALL STUDENTS                          ║" << endl;
-        cout << "╚════════════════════════════════════════════════════════════╝" << endl;
-        cout << left << setw(10) << "Roll No" << setw(20) << "Name" 
-             << setw(15) << "Course" << setw(10) << "Average" << "Grade" << endl;
-        cout << string(65, '-') << endl;
+        // Range shards split the generated roll numbers evenly
+        int width = static_cast<int>((numStudents + numShards - 1) / numShards);
+        ShardRouter router(paths, mode, width);
         
-        for (auto student : students) {
-            cout << left << setw(10) << student->getRollNo() 
-                 << setw(20) << student->getName()
-                 << setw(15) << student->getCourse()
-                 << setw(10) << fixed << setprecision(2) << student->getAverage()
-                 << student->getGrade() << endl;
+        vector<Student*> generated;
+        const char* courses[] = {"CS", "EE", "ME", "CE", "IT"};
+        unsigned int seed = 12345;
+        for (size_t i = 0; i < numStudents; i++) {
+            Student* s = new Student(static_cast<int>(i + 1), "Student " + std::to_string(i + 1), courses[i % 5], 5);
+            for (int j = 0; j < 5; j++) {
+                seed = seed * 1103515245u + 12345u;
+                s->setMarks(j, static_cast<int>((seed >> 16) % 101));
+            }
+            generated.push_back(s);
+        }
+        
+        auto start = Clock::now();
+        router.addStudents(generated);
+        cout << "Loaded " << numStudents << " students into " << numShards
+             << (mode == ShardingMode::Hash ? " hash" : " range") << " shards in "
+             << fixed << setprecision(3) << seconds(start) << " s" << endl;
+        for (auto s : generated) delete s;
+        
+        start = Clock::now();
+        Student found;
+        bool ok = router.findStudent(static_cast<int>(numStudents / 2 + 1), found);
+        cout << "findStudent: " << (ok ? "found " + string(found.getName()) : string("not found"))
+             << " in " << seconds(start) * 1000 << " ms" << endl;
+        
+        start = Clock::now();
+        vector<Student> top = router.topK(5);
+        cout << "Top 5 in " << seconds(start) * 1000 << " ms:" << endl;
+        for (auto& s : top) cout << "  " << s << endl;
+        
+        start = Clock::now();
+        CohortStats stats = router.statistics();
+        cout << "Statistics in " << seconds(start) * 1000 << " ms: count " << stats.count
+             << ", mean " << setprecision(2) << stats.mean() << ", min " << stats.minAverage
+             << ", max " << stats.maxAverage << endl;
+        
+        start = Clock::now();
+        vector<Student> all = router.listStudents();
+        cout << "Listing of " << all.size() << " students in " << setprecision(3)
+             << seconds(start) << " s" << endl;
+        
+        router.shutdown();
+    } catch (const exception& e) {
+        cout << "✗ Error: " << e.what() << endl;
+        for (pid_t pid : children) ::kill(pid, SIGTERM);
+        status = 1;
+    }
+    for (pid_t pid : children) ::waitpid(pid, nullptr, 0);
+    for (auto& path : paths) ::unlink(path.c_str());
+    return status;
+}
+#endif
+
+// Floods checkLogin with bad passwords from several threads while the main
+// thread, logged in as admin, enters marks through ManagementSystem (the
+// path conductExam uses), and compares mark-entry latency with a quiet run
+int runLoginBenchmark(size_t attempts) {
+    typedef std::chrono::steady_clock Clock;
+    const int numStudents = 10000;
+    ManagementSystem system;
+    {
+        // Populate through a snapshot, the system's only non-interactive bulk path
+        vector<Student*> seed;
+        for (int i = 0; i < numStudents; i++) {
+            seed.push_back(new Student(i + 1, "Student " + std::to_string(i + 1), "CS", 5));
+        }
+        DerivedStudentData none;
+        string file = "sms_login_bench.snap";
+        bool loaded = false;
+        try {
+            snapshot::save(file, seed, none);
+            loaded = system.loadSnapshot(file);
+        } catch (const exception& e) {
+            cout << "✗ Error: " << e.what() << endl;
         }
+        for (auto s : seed) delete s;
+        std::remove(file.c_str());
+        if (!loaded) return 1;
     }
+    if (system.login("admin", "admin123", "bench") != LoginStatus::Success) return 1;
     
-    // Helper function to find student by roll number
-    Student* findStudent(int roll) {
-        for (auto student : students) {
-            if (student->getRollNo() == roll) {
-                return student;
+    // Mark entry for n students; returns per-entry latencies in microseconds
+    auto enterMarks = [&](size_t n) {
+        vector<double> latency;
+        latency.reserve(n);
+        Student scratch;
+        for (size_t i = 0; i < n; i++) {
+            auto start = Clock::now();
+            system.enterMarks(static_cast<int>(i % numStudents) + 1, scratch, [i](const Student&, int subject) {
+                return static_cast<int>((i + subject) % 101);
+            });
+            latency.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        }
+        std::sort(latency.begin(), latency.end());
+        return latency;
+    };
+    auto report = [](const char* label, const vector<double>& latency) {
+        cout << left << setw(28) << label << fixed << setprecision(3)
+             << "p50 " << latency[latency.size() / 2] << " us   p99 " << latency[latency.size() * 99 / 100]
+             << " us   max " << latency.back() << " us" << endl;
+    };
+    
+    const size_t entries = 200000;
+    report("Mark entry (quiet):", enterMarks(entries));
+    
+    // The flood: attackers cycle through sources and usernames
+    std::atomic<size_t> limited(0), rejected(0);
+    unsigned numAttackers = std::max(2u, std::thread::hardware_concurrency() / 2);
+    auto floodStart = Clock::now();
+    vector<std::thread> attackers;
+    for (unsigned t = 0; t < numAttackers; t++) {
+        attackers.emplace_back([&, t] {
+            for (size_t i = t; i < attempts; i += numAttackers) {
+                LoginStatus status = system.checkLogin(i % 2 ? "admin" : "user" + std::to_string(i % 5000),
+                                                       "guess" + std::to_string(i),
+                                                       "10.0." + std::to_string(i % 256) + ".7");
+                if (status == LoginStatus::RateLimited) limited++;
+                else if (status == LoginStatus::InvalidCredentials) rejected++;
             }
+        });
+    }
+    vector<double> underFlood = enterMarks(entries);
+    for (auto& attacker : attackers) attacker.join();
+    double floodMs = std::chrono::duration<double, std::milli>(Clock::now() - floodStart).count();
+    report("Mark entry (during flood):", underFlood);
+    cout << attempts << " bad logins from " << numAttackers << " threads in " << setprecision(1) << floodMs
+         << " ms: " << limited << " rate-limited, " << rejected << " rejected" << endl;
+    
+    // For comparison: the cost of reporting each failure with an exception
+    auto start = Clock::now();
+    size_t caught = 0;
+    for (size_t i = 0; i < attempts; i++) {
+        try {
+            throw InvalidCredentialsException("Invalid username or password");
+        } catch (const InvalidCredentialsException&) {
+            caught++;
         }
-        return nullptr;
     }
+    cout << caught << " throw/catch of InvalidCredentialsException alone: "
+         << std::chrono::duration<double, std::milli>(Clock::now() - start).count() << " ms" << endl;
     
-    User* getCurrentUser() const { return currentUser; }
-};
+    // Successful logins give their tokens back: well past the burst of 5
+    // attempts, a legitimate user can still log in and out
+    int relogins = 0;
+    for (int i = 0; i < 20; i++) {
+        if (system.checkLogin("teacher1", "teacher123", "console") == LoginStatus::Success) relogins++;
+    }
+    cout << relogins << "/20 back-to-back logins by a legitimate user succeeded" << endl;
+    return relogins == 20 ? 0 : 1;
+}
 
 // ==================== MAIN MENU FUNCTIONS ====================
 void displayMainMenu() {
@@ -778,23 +5289,161 @@ void displayUserMenu(User* user) {
         cout << "4. Search Student by Roll Number" << endl;
         cout << "5. Sort Students by Marks" << endl;
         cout << "6. Display All Students" << endl;
-        cout << "7. Logout" << endl;
-        cout << "8. Exit" << endl;
+        cout << "7. Reports & Tools" << endl;
+        cout << "8. Logout" << endl;
+        cout << "9. Exit" << endl;
     } else if (user->getRole() == "Teacher") {
         cout << "1. Conduct Exam & Enter Marks" << endl;
         cout << "2. Search Student by Roll Number" << endl;
         cout << "3. Sort Students by Marks" << endl;
         cout << "4. Display All Students" << endl;
-        cout << "5. Logout" << endl;
-        cout << "6. Exit" << endl;
+        cout << "5. Reports & Tools" << endl;
+        cout << "6. Logout" << endl;
+        cout << "7. Exit" << endl;
     }
     
     cout << "Enter choice: ";
 }
 
+// Reports & Tools submenu (each tool checks the user's role itself)
+void runToolsMenu(ManagementSystem& system) {
+    cout << "\n╔════════════════════════════════════════════════════════════╗" << endl;
+    cout << "║                    REPORTS & TOOLS                         ║" << endl;
+    cout << "╚════════════════════════════════════════════════════════════╝" << endl;
+    cout << "1. Change Grading Scheme" << endl;
+    cout << "2. Generate Transcripts (per course)" << endl;
+    cout << "3. Export Students to CSV (background)" << endl;
+    cout << "4. Export Status" << endl;
+    cout << "5. Change Feed (start / status)" << endl;
+    cout << "6. Schedule Exams & Seating" << endl;
+    cout << "7. Analytics Query" << endl;
+    cout << "8. Memory Report" << endl;
+    cout << "9. Student Archive (on disk)" << endl;
+    cout << "10. Save / Load Snapshot" << endl;
+    cout << "0. Back" << endl;
+    cout << "Enter choice: ";
+    
+    int choice;
+    cin >> choice;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    
+    switch (choice) {
+        case 1:
+            system.changeGradingScheme();
+            break;
+        case 2:
+            system.generateTranscripts();
+            break;
+        case 3:
+            system.startExport();
+            break;
+        case 4:
+            system.showExportStatus();
+            break;
+        case 5:
+            system.manageChangeFeed();
+            break;
+        case 6:
+            system.scheduleExams();
+            break;
+        case 7:
+            system.runAnalyticsQuery();
+            break;
+        case 8:
+            system.showMemoryReport();
+            break;
+        case 9:
+            system.manageArchive();
+            break;
+        case 10:
+            system.manageSnapshot();
+            break;
+        case 0:
+            break;
+        default:
+            cout << "\n✗ Invalid choice!" << endl;
+    }
+}
+
+// Command-line modes for tools that run without the interactive menu
+int runCommandLine(int argc, char* argv[]) {
+    string mode = argv[1];
+    try {
+        if (mode == "--bench-schedule") {
+            size_t numStudents = argc > 2 ? std::stoul(argv[2]) : 1000000;
+            size_t numPapers = argc > 3 ? std::stoul(argv[3]) : 2000;
+            size_t numRooms = argc > 4 ? std::stoul(argv[4]) : 300;
+            return runScheduleBenchmark(numStudents, numPapers, numRooms);
+        }
+        if (mode == "--bench-login") {
+            return runLoginBenchmark(argc > 2 ? std::stoul(argv[2]) : 100000);
+        }
+        if (mode == "--bench-memory") {
+            return runMemoryBenchmark(argc > 2 ? std::stoul(argv[2]) : 1000000);
+        }
+        if (mode == "--bench-snapshot") {
+            return runSnapshotBenchmark(argc > 2 ? std::stoul(argv[2]) : 1000000);
+        }
+        if (mode == "--bench-query") {
+            return runQueryBenchmark(argc > 2 ? std::stoul(argv[2]) : 1000000);
+        }
+#if SMS_HAVE_POSIX
+        if (mode == "--shard-server" && argc == 3) {
+            ShardServer server;
+            server.serve(argv[2]);
+            return 0;
+        }
+        if (mode == "--shard-demo") {
+            size_t shards = argc > 2 ? std::stoul(argv[2]) : 4;
+            size_t count = argc > 3 ? std::stoul(argv[3]) : 100000;
+            bool hash = argc > 4 && string(argv[4]) == "hash";
+            return runShardDemo(shards, count, hash ? ShardingMode::Hash : ShardingMode::Range);
+        }
+        if (mode == "--bench-archive") {
+            size_t records = argc > 2 ? std::stoul(argv[2]) : 1000000;
+            size_t budgetMB = argc > 3 ? std::stoul(argv[3]) : 16;
+            return runArchiveBenchmark(records, budgetMB);
+        }
+        if (mode == "--cdc-tail" && (argc == 3 || argc == 4)) {
+            return runChangeFeedTail(argv[2], argc == 4 ? std::stoull(argv[3]) : 0);
+        }
+#endif
+    } catch (const std::logic_error& e) {
+        cout << "✗ Error: invalid number" << endl;
+        return 1;
+    } catch (const exception& e) {
+        cout << "✗ Error: " << e.what() << endl;
+        return 1;
+    }
+    
+    cout << "Usage:" << endl;
+    cout << "  " << argv[0] << "                        interactive menu" << endl;
+    cout << "  " << argv[0] << " --snapshot <file>      interactive menu, students loaded from a snapshot" << endl;
+    cout << "  " << argv[0] << " --bench-schedule [students] [papers] [rooms]" << endl;
+    cout << "  " << argv[0] << " --bench-query [students]" << endl;
+    cout << "  " << argv[0] << " --bench-memory [students]" << endl;
+    cout << "  " << argv[0] << " --bench-login [attempts]" << endl;
+    cout << "  " << argv[0] << " --bench-snapshot [students]" << endl;
+#if SMS_HAVE_POSIX
+    cout << "  " << argv[0] << " --shard-server <socket>  run one shard server" << endl;
+    cout << "  " << argv[0] << " --shard-demo [shards] [students] [range|hash]" << endl;
+    cout << "  " << argv[0] << " --cdc-tail <socket> [offset]  follow the change feed" << endl;
+    cout << "  " << argv[0] << " --bench-archive [records] [budget MB]" << endl;
+#endif
+    return 1;
+}
+
 // ==================== MAIN FUNCTION ====================
-int main() {
+int main(int argc, char* argv[]) {
+    bool withSnapshot = argc == 3 && string(argv[1]) == "--snapshot";
+    if (argc > 1 && !withSnapshot) {
+        return runCommandLine(argc, argv);
+    }
+    
     ManagementSystem system;
+    if (withSnapshot && !system.loadSnapshot(argv[2])) {
+        return 1;
+    }
     
     cout << "\n╔════════════════════════════════════════════════════════════╗" << endl;
     cout << "║                         WELCOME TO                         ║" << endl;
@@ -865,9 +5514,12 @@ int main() {
                         system.displayAllStudents();
                         break;
                     case 7:
-                        system.logout();
+                        runToolsMenu(system);
                         break;
                     case 8:
+                        system.logout();
+                        break;
+                    case 9:
                         cout << "\nThank you for using the system. Goodbye!" << endl;
                         return 0;
                     default:
@@ -888,9 +5540,12 @@ int main() {
                         system.displayAllStudents();
                         break;
                     case 5:
-                        system.logout();
+                        runToolsMenu(system);
                         break;
                     case 6:
+                        system.logout();
+                        break;
+                    case 7:
                         cout << "\nThank you for using the system. Goodbye!" << endl;
                         return 0;
                     default: